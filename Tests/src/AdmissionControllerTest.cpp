@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+#include "Functions.h"
+
+#include "AdmissionController.h"
+
+using namespace std::chrono_literals;
+
+TEST(AdmissionController, MaxInFlight)
+{
+	threading::ThreadPool threadPool(1);
+	threading::AdmissionController controller(threadPool, 0us, 100ms, 2);
+	std::atomic_bool blocked = true;
+
+	std::unique_ptr<threading::Future> blocker = controller.addTask([&blocked]() { while (blocked); });
+	std::unique_ptr<threading::Future> queued = controller.addTask(sum, nullptr, 0, 10);
+	std::unique_ptr<threading::Future> rejected = controller.addTask(sum, nullptr, 0, 10);
+
+	ASSERT_EQ(controller.getInFlightTasks(), 2);
+
+	try
+	{
+		rejected->get<int64_t>();
+
+		FAIL();
+	}
+	catch (const threading::AdmissionRejected& exception)
+	{
+		ASSERT_EQ(exception.getReason(), threading::AdmissionRejected::Reason::maxInFlight);
+	}
+
+	blocked = false;
+
+	ASSERT_EQ(queued->get<int64_t>(), sum(0, 10));
+	ASSERT_EQ(controller.getAcceptedTasks(), 2);
+	ASSERT_EQ(controller.getRejectedTasks(), 1);
+	ASSERT_EQ(controller.getShedTasks(), 0);
+}
+
+TEST(AdmissionController, RejectedVoidTask)
+{
+	threading::ThreadPool threadPool(1);
+	threading::AdmissionController controller(threadPool, 0us, 100ms, 1);
+	std::atomic_bool blocked = true;
+	std::atomic_bool executed = false;
+
+	std::unique_ptr<threading::Future> blocker = controller.addTask([&blocked]() { while (blocked); });
+	std::unique_ptr<threading::Future> rejected = controller.addTask([&executed]() { executed = true; });
+
+	try
+	{
+		rejected->get<void>();
+
+		FAIL();
+	}
+	catch (const threading::AdmissionRejected& exception)
+	{
+		ASSERT_EQ(exception.getReason(), threading::AdmissionRejected::Reason::maxInFlight);
+	}
+
+	blocked = false;
+
+	ASSERT_NO_THROW(blocker->get<void>());
+	ASSERT_FALSE(executed);
+	ASSERT_EQ(controller.getRejectedTasks(), 1);
+}
+
+TEST(AdmissionController, TargetDelay)
+{
+	threading::ThreadPool threadPool(1);
+	threading::AdmissionController controller(threadPool, 1ms, 10ms);
+	std::vector<std::unique_ptr<threading::Future>> accepted;
+	size_t shedTasks = 0;
+	size_t acceptedBetweenDrops = 0;
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		accepted.emplace_back(controller.addTask([]() { std::this_thread::sleep_for(5ms); }));
+	}
+
+	// Queue stands above target delay, so tasks are shed on drop schedule until it drains
+	while (controller.getInFlightTasks())
+	{
+		size_t previousShedTasks = controller.getShedTasks();
+		std::unique_ptr<threading::Future> future = controller.addTask([]() { return 0; }, nullptr);
+
+		if (controller.getShedTasks() == previousShedTasks)
+		{
+			accepted.emplace_back(std::move(future));
+
+			if (shedTasks)
+			{
+				acceptedBetweenDrops++;
+			}
+		}
+		else
+		{
+			ASSERT_THROW(future->get<int>(), threading::AdmissionRejected);
+
+			shedTasks++;
+		}
+
+		std::this_thread::sleep_for(1ms);
+	}
+
+	ASSERT_GT(shedTasks, 0);
+	ASSERT_GT(acceptedBetweenDrops, 0);
+	ASSERT_EQ(controller.getShedTasks(), shedTasks);
+	ASSERT_EQ(controller.getAcceptedTasks(), accepted.size());
+	ASSERT_GT(controller.getAverageWaitTime(), 1ms);
+	ASSERT_GT(controller.getAverageQueueDepth(), 0.0);
+
+	// Drained queue accepts tasks again
+	ASSERT_EQ(controller.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+}
+
+TEST(AdmissionController, ThrowingTask)
+{
+	threading::ThreadPool threadPool(1);
+	threading::AdmissionController controller(threadPool, 0us, 100ms, 1);
+	std::atomic_bool blocked = true;
+
+	std::unique_ptr<threading::Future> blocker = threadPool.addTask([&blocked]() { while (blocked); });
+
+	while (!threadPool.isAnyTaskRunning());
+
+	std::unique_ptr<threading::Future> future = controller.addTask([]() { throw std::runtime_error("task"); });
+
+	ASSERT_THROW(threadPool.runPending(), std::runtime_error);
+	ASSERT_EQ(controller.getInFlightTasks(), 0);
+
+	blocked = false;
+
+	ASSERT_EQ(controller.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+}
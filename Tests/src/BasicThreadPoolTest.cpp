@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+
+#include <mutex>
+#include <algorithm>
+
+#include "Functions.h"
+
+#include "BasicThreadPool.h"
+#include "ThreadPool.h"
+
+/// @brief Run same scenario on one thread of any pool. Returns execution order of tasks and queued tasks count while worker was busy
+template<typename ThreadPoolT, typename AddTaskT, typename ShutdownT>
+static std::pair<std::vector<int>, size_t> runScenario(ThreadPoolT& threadPool, AddTaskT&& addTask, ShutdownT&& shutdown)
+{
+	std::atomic_bool started = false;
+	std::atomic_bool release = false;
+	std::mutex mutex;
+	std::vector<int> order;
+
+	addTask
+	(
+		[&started, &release]()
+		{
+			started = true;
+
+			while (!release)
+			{
+				std::this_thread::yield();
+			}
+		}
+	);
+
+	while (!started)
+	{
+		std::this_thread::yield();
+	}
+
+	for (int i = 0; i < 100; i++)
+	{
+		addTask([&mutex, &order, i]() { std::unique_lock<std::mutex> lock(mutex); order.push_back(i); });
+	}
+
+	size_t queued = threadPool.getQueuedTasks();
+
+	release = true;
+
+	shutdown();
+
+	return { order, queued };
+}
+
+TEST(BasicThreadPool, Default)
+{
+	std::atomic<int64_t> result = 0;
+
+	{
+		threading::BasicThreadPool<> threadPool(4);
+
+		for (int64_t i = 0; i < 1000; i++)
+		{
+			threadPool.addTask([&result, i]() { result += sum(i * 10, (i + 1) * 10); });
+		}
+	}
+
+	ASSERT_EQ(result, sum(0, 10'000));
+}
+
+TEST(BasicThreadPool, Policies)
+{
+	using ThreadPoolT = threading::BasicThreadPool
+	<
+		threading::policies::LockFreeQueue<256>,
+		threading::policies::SpinningIdle,
+		threading::policies::InplaceTask<32>,
+		threading::policies::CountingMetrics
+	>;
+
+	std::atomic<int64_t> result = 0;
+	size_t executed = 0;
+
+	{
+		ThreadPoolT threadPool(2);
+
+		for (int64_t i = 0; i < 10'000; i++)
+		{
+			std::unique_ptr<int64_t> value = std::make_unique<int64_t>(i);
+
+			threadPool.addTask([&result, value = std::move(value)]() { result += *value; });
+		}
+
+		threadPool.shutdown();
+
+		executed = threadPool.getMetrics().getExecutedTasks();
+
+		ASSERT_EQ(threadPool.getMetrics().getSubmittedTasks(), 10'000);
+	}
+
+	ASSERT_EQ(executed, 10'000);
+	ASSERT_EQ(result, sum(0, 10'000));
+}
+
+TEST(BasicThreadPool, MatchesThreadPool)
+{
+	threading::BasicThreadPool<> basicThreadPool(1);
+	threading::ThreadPool threadPool(1);
+
+	// Default policies keep behaviour of ThreadPool: FIFO order, exact queue size and shutdown that executes queued tasks
+	auto [basicOrder, basicQueued] = runScenario
+	(
+		basicThreadPool,
+		[&basicThreadPool](std::function<void()>&& task) { basicThreadPool.addTask(std::move(task)); },
+		[&basicThreadPool]() { basicThreadPool.shutdown(); }
+	);
+
+	auto [order, queued] = runScenario
+	(
+		threadPool,
+		[&threadPool](std::function<void()>&& task) { threadPool.addTask(std::move(task)); },
+		[&threadPool]() { threadPool.shutdown(true); }
+	);
+
+	ASSERT_EQ(basicOrder.size(), 100);
+	ASSERT_EQ(basicOrder, order);
+	ASSERT_TRUE(std::ranges::is_sorted(basicOrder));
+	ASSERT_EQ(basicQueued, 100);
+	ASSERT_EQ(basicQueued, queued);
+	ASSERT_EQ(basicThreadPool.size(), threadPool.size());
+}
@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <numeric>
+#include <set>
+
+#include "Functions.h"
+
+#include "ParallelFor.h"
+
+using namespace std::chrono_literals;
+
+TEST(ParallelFor, Schedules)
+{
+	threading::ThreadPool threadPool(4);
+
+	for (threading::LoopSchedule schedule : { threading::LoopSchedule::fixed, threading::LoopSchedule::dynamic, threading::LoopSchedule::guided, threading::LoopSchedule::tuned })
+	{
+		for (size_t chunkSize : { 0, 1, 7, 1000 })
+		{
+			std::vector<int> visited(10000);
+
+			threading::LoopStatistics statistics = threading::parallelFor(threadPool, 0, static_cast<int>(visited.size()), [&visited](int i) { visited[i]++; }, schedule, chunkSize);
+
+			ASSERT_TRUE(std::ranges::all_of(visited, [](int value) { return value == 1; }));
+			ASSERT_EQ(statistics.chunks.size(), 4);
+			ASSERT_EQ(std::accumulate(statistics.iterations.begin(), statistics.iterations.end(), static_cast<size_t>(0)), visited.size());
+			ASSERT_GE(statistics.imbalance, 1.0);
+		}
+	}
+
+	ASSERT_EQ(threading::parallelFor(threadPool, 10, 0, [](int) {}).chunks.size(), 1);
+}
+
+TEST(ParallelFor, Imbalance)
+{
+	threading::ThreadPool threadPool(4);
+
+	// Cost grows with index, so last equal block takes most of the time
+	auto skewed = [](int64_t i) { std::this_thread::sleep_for(std::chrono::microseconds(i)); };
+
+	threading::LoopStatistics fixed = threading::parallelFor(threadPool, static_cast<int64_t>(0), static_cast<int64_t>(200), skewed);
+	threading::LoopStatistics dynamic = threading::parallelFor(threadPool, static_cast<int64_t>(0), static_cast<int64_t>(200), skewed, threading::LoopSchedule::dynamic, 4);
+
+	std::cout << fixed.imbalance << ' ' << dynamic.imbalance << std::endl;
+
+	ASSERT_EQ(fixed.chunks, std::vector<size_t>(4, 1));
+	ASSERT_LT(dynamic.imbalance, fixed.imbalance);
+}
+
+TEST(ParallelFor, Tuned)
+{
+	threading::ThreadPool threadPool(4);
+	std::set<size_t> chunkSizes;
+	std::atomic<int64_t> result = 0;
+
+	threading::LoopTuner::reset();
+
+	for (size_t i = 0; i < 8; i++)
+	{
+		chunkSizes.insert(threading::parallelFor(threadPool, 0, 4096, [&result](int i) { result += i; }, threading::LoopSchedule::tuned).chunkSize);
+	}
+
+	// All candidates are tried before best one is reused
+	ASSERT_EQ(chunkSizes, std::set<size_t>({ 1024, 256, 64, 16, 4 }));
+	ASSERT_EQ(result, sum(0, 4096) * 8);
+}
+
+TEST(ParallelFor, TunedSmallLoop)
+{
+	threading::ThreadPool threadPool(4);
+	std::vector<size_t> chunkSizes;
+
+	threading::LoopTuner::reset();
+
+	for (size_t i = 0; i < 30; i++)
+	{
+		chunkSizes.push_back(threading::parallelFor(threadPool, 0, 200, [](int) {}, threading::LoopSchedule::tuned).chunkSize);
+	}
+
+	// Candidates 50, 12, 3 and 1 are sampled twice, clamped duplicates of 1 are skipped
+	ASSERT_EQ(std::set<size_t>(chunkSizes.begin(), chunkSizes.begin() + 8), std::set<size_t>({ 50, 12, 3, 1 }));
+	ASSERT_TRUE(std::all_of(chunkSizes.begin() + 8, chunkSizes.end(), [&chunkSizes](size_t chunkSize) { return chunkSize == chunkSizes[8]; }));
+}
+
+TEST(ParallelFor, Resize)
+{
+	threading::ThreadPool threadPool(2);
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::atomic<int64_t> total = 0;
+
+	// Nested loops read number of threads on workers while ThreadPool is resized
+	for (size_t i = 0; i < 20; i++)
+	{
+		result.emplace_back(threadPool.addTask([&threadPool, &total]() { threading::parallelFor(threadPool, 0, 1000, [&total](int i) { total += i; }, threading::LoopSchedule::dynamic, 16); }));
+
+		threadPool.resize(1 + i % 4);
+	}
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_EQ(total, sum(0, 1000) * 20);
+}
+
+TEST(ParallelFor, Exception)
+{
+	threading::ThreadPool threadPool(2);
+
+	ASSERT_THROW(threading::parallelFor(threadPool, 0, 1000, [](int i) { if (i == 500) throw std::runtime_error("body"); }, threading::LoopSchedule::dynamic), std::runtime_error);
+}
@@ -0,0 +1,212 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <algorithm>
+#include <mutex>
+
+#include "Functions.h"
+
+#include "Partition.h"
+
+using namespace std::chrono_literals;
+
+TEST(Partition, AddTask)
+{
+	threading::ThreadPool threadPool(4);
+	threading::Partition compute(threadPool, 2);
+	threading::Partition io(threadPool);
+	std::vector<std::unique_ptr<threading::Future>> result;
+
+	for (int64_t i = 0; i < 100; i++)
+	{
+		result.emplace_back(compute.addTask(sum, nullptr, i * 10, (i + 1) * 10));
+		result.emplace_back(io.addTask(sum, nullptr, i * 10, (i + 1) * 10));
+	}
+
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		int64_t left = static_cast<int64_t>(i / 2) * 10;
+
+		ASSERT_EQ(result[i]->get<int64_t>(), sum(left, left + 10));
+	}
+
+	ASSERT_EQ(compute.getQueuedTasks(), 0);
+	ASSERT_EQ(io.getQueuedTasks(), 0);
+	ASSERT_EQ(compute.getWeight(), 2);
+}
+
+TEST(Partition, MaxConcurrency)
+{
+	threading::ThreadPool threadPool(8);
+	threading::Partition partition(threadPool, 1, 2);
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::atomic_int current = 0;
+	std::atomic_int max = 0;
+
+	for (size_t i = 0; i < 16; i++)
+	{
+		result.emplace_back
+		(
+			partition.addTask
+			(
+				[&current, &max]()
+				{
+					int value = ++current;
+					int previous = max;
+
+					while (previous < value && !max.compare_exchange_weak(previous, value));
+
+					std::this_thread::sleep_for(10ms);
+
+					current--;
+				}
+			)
+		);
+	}
+
+	ASSERT_GT(partition.getQueuedTasks(), 0);
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_LE(max, 2);
+	ASSERT_EQ(partition.getMaxConcurrency(), 2);
+}
+
+TEST(Partition, Resize)
+{
+	threading::ThreadPool threadPool(2);
+	threading::Partition partition(threadPool);
+	std::vector<std::unique_ptr<threading::Future>> result;
+
+	// Partition reads size of ThreadPool from worker threads while it is resized
+	for (size_t i = 0; i < 20; i++)
+	{
+		for (int64_t j = 0; j < 50; j++)
+		{
+			result.emplace_back(partition.addTask(sum, nullptr, j * 10, (j + 1) * 10));
+		}
+
+		threadPool.resize(1 + i % 4);
+	}
+
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		int64_t left = static_cast<int64_t>(i % 50) * 10;
+
+		ASSERT_EQ(result[i]->get<int64_t>(), sum(left, left + 10));
+	}
+
+	ASSERT_EQ(partition.getQueuedTasks(), 0);
+}
+
+TEST(Partition, Weight)
+{
+	threading::ThreadPool threadPool(1);
+	threading::Partition heavy(threadPool, 3);
+	threading::Partition light(threadPool, 1);
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::atomic_bool started = false;
+	std::atomic_bool release = false;
+	std::mutex mutex;
+	std::vector<int> order;
+	constexpr size_t tasksCount = 200;
+
+	// Both partitions are filled before worker starts draining them
+	result.emplace_back
+	(
+		threadPool.addTask
+		(
+			[&started, &release]()
+			{
+				started = true;
+
+				while (!release)
+				{
+					std::this_thread::yield();
+				}
+			}
+		)
+	);
+
+	while (!started)
+	{
+		std::this_thread::yield();
+	}
+
+	for (size_t i = 0; i < tasksCount; i++)
+	{
+		result.emplace_back(heavy.addTask([&mutex, &order]() { std::unique_lock<std::mutex> lock(mutex); order.push_back(0); }));
+		result.emplace_back(light.addTask([&mutex, &order]() { std::unique_lock<std::mutex> lock(mutex); order.push_back(1); }));
+	}
+
+	release = true;
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_EQ(order.size(), tasksCount * 2);
+
+	// While both partitions have tasks heavy one gets about 3 times more turns
+	size_t heavyCount = std::count(order.begin(), order.begin() + tasksCount, 0);
+	size_t lightCount = tasksCount - heavyCount;
+
+	ASSERT_GT(lightCount, 0);
+
+	double ratio = static_cast<double>(heavyCount) / lightCount;
+
+	ASSERT_GT(ratio, 2.0);
+	ASSERT_LT(ratio, 4.5);
+}
+
+TEST(Partition, ShutdownWithoutWait)
+{
+	threading::ThreadPool threadPool(1);
+	threading::Partition partition(threadPool, 1, 1);
+	std::atomic_bool started = false;
+	std::atomic_bool release = false;
+	std::atomic_int executed = 0;
+
+	threadPool.addTask
+	(
+		[&started, &release]()
+		{
+			started = true;
+
+			while (!release)
+			{
+				std::this_thread::yield();
+			}
+		}
+	);
+
+	while (!started)
+	{
+		std::this_thread::yield();
+	}
+
+	// Drain of this task waits behind blocked worker and is dropped by shutdown
+	partition.addTask([&executed]() { executed++; });
+
+	threadPool.shutdown(false);
+
+	release = true;
+
+	threadPool.reinit(true, 1);
+
+	partition.addTask([&executed]() { executed++; });
+
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + 5s;
+
+	while (executed != 2 && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(1ms);
+	}
+
+	ASSERT_EQ(executed, 2);
+	ASSERT_EQ(partition.getQueuedTasks(), 0);
+}
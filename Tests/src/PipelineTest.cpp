@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+#include "Functions.h"
+
+#include "Pipeline.h"
+
+using namespace std::chrono_literals;
+
+TEST(Pipeline, Order)
+{
+	threading::ThreadPool threadPool(4);
+	threading::Pipeline<int64_t> pipeline(threadPool, 16);
+	std::atomic_int inFlight = 0;
+	std::atomic_int maxInFlight = 0;
+	std::vector<int64_t> result;
+	int64_t next = 0;
+
+	pipeline.addParallelStage
+	(
+		[&inFlight, &maxInFlight](int64_t& value)
+		{
+			int current = ++inFlight;
+			int previous = maxInFlight;
+
+			while (previous < current && !maxInFlight.compare_exchange_weak(previous, current));
+
+			value = sum(0, value);
+		}
+	);
+	pipeline.addSerialStage
+	(
+		[&inFlight, &result](int64_t& value)
+		{
+			result.push_back(value);
+
+			inFlight--;
+		}
+	);
+
+	pipeline.run
+	(
+		[&next](int64_t& value)
+		{
+			value = next++;
+
+			return value < 10000;
+		}
+	);
+
+	ASSERT_EQ(result.size(), 10000);
+
+	for (int64_t i = 0; i < 10000; i++)
+	{
+		ASSERT_EQ(result[i], sum(0, i));
+	}
+
+	ASSERT_LE(maxInFlight, 16);
+	ASSERT_EQ(pipeline.getStageStatistics(0).processedItems, 10000);
+	ASSERT_EQ(pipeline.getStageStatistics(1).processedItems, 10000);
+	ASSERT_GT(pipeline.getStageStatistics(1).throughput, 0.0);
+	ASSERT_THROW(pipeline.getStageStatistics(2), std::out_of_range);
+}
+
+TEST(Pipeline, MaxConcurrency)
+{
+	threading::ThreadPool threadPool(4);
+	threading::Pipeline<int> pipeline(threadPool, 16);
+	std::atomic_int current = 0;
+	std::atomic_int max = 0;
+	int next = 0;
+
+	pipeline.addParallelStage
+	(
+		[&current, &max](int&)
+		{
+			int value = ++current;
+			int previous = max;
+
+			while (previous < value && !max.compare_exchange_weak(previous, value));
+
+			std::this_thread::sleep_for(100us);
+
+			current--;
+		},
+		2
+	);
+
+	pipeline.run([&next](int& value) { value = next++; return value < 200; });
+
+	ASSERT_LE(max, 2);
+	ASSERT_EQ(pipeline.getStageStatistics(0).processedItems, 200);
+}
+
+TEST(Pipeline, Exception)
+{
+	threading::ThreadPool threadPool(2);
+	threading::Pipeline<int> pipeline(threadPool, 4);
+	std::atomic_int processed = 0;
+	int next = 0;
+
+	pipeline.addParallelStage
+	(
+		[](int& value)
+		{
+			if (value == 10)
+			{
+				throw std::runtime_error("stage");
+			}
+		}
+	);
+	pipeline.addSerialStage([&processed](int&) { processed++; });
+
+	ASSERT_THROW(pipeline.run([&next](int& value) { value = next++; return true; }), std::runtime_error);
+	ASSERT_LT(processed, 20);
+
+	int processedBefore = processed;
+
+	next = 0;
+
+	// Pipeline is reusable after exception
+	pipeline.run([&next](int& value) { value = next++; return value < 5; });
+
+	ASSERT_EQ(processed, processedBefore + 5);
+}
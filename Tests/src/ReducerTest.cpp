@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+
+#include "Functions.h"
+
+#include "ThreadPool.h"
+#include "Reducer.h"
+
+TEST(Reducer, Sum)
+{
+	threading::ThreadPool threadPool(4);
+	threading::Reducer<int64_t> reducer;
+	std::atomic_size_t finished = 0;
+
+	for (int64_t i = 0; i < 1000; i++)
+	{
+		threadPool.addTask
+		(
+			sum,
+			[&reducer, &finished](int64_t&& value)
+			{
+				reducer.add(value);
+
+				finished++;
+			},
+			i * 10,
+			(i + 1) * 10
+		);
+	}
+
+	while (finished != 1000)
+	{
+		std::this_thread::yield();
+	}
+
+	ASSERT_EQ(reducer.get(), sum(0, 10000));
+
+	reducer.reset();
+
+	ASSERT_EQ(reducer.get(), 0);
+}
+
+TEST(Reducer, Operation)
+{
+	threading::ThreadPool threadPool(4);
+	threading::Reducer<int64_t, std::function<int64_t(int64_t, int64_t)>> reducer((std::numeric_limits<int64_t>::min)(), [](int64_t left, int64_t right) { return (std::max)(left, right); }, 2);
+	std::atomic_size_t finished = 0;
+
+	for (int64_t i = 0; i < 1000; i++)
+	{
+		threadPool.spawn
+		(
+			[&reducer, &finished](int64_t value)
+			{
+				reducer.add(value * 7 % 1000);
+
+				finished++;
+			},
+			i
+		);
+	}
+
+	while (finished != 1000)
+	{
+		std::this_thread::yield();
+	}
+
+	ASSERT_EQ(reducer.get(), 999);
+	ASSERT_EQ(reducer.getSlotsCount(), 2);
+}
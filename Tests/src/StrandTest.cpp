@@ -0,0 +1,123 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+#include "Functions.h"
+
+#include "Strand.h"
+
+using namespace std::chrono_literals;
+
+TEST(Strand, Order)
+{
+	threading::ThreadPool threadPool(4);
+	threading::Strand strand(threadPool, 8);
+	std::vector<std::thread> producers;
+	std::vector<std::vector<size_t>> executed(4);
+	std::atomic_int running = 0;
+	std::atomic_bool overlapped = false;
+
+	for (size_t i = 0; i < executed.size(); i++)
+	{
+		producers.emplace_back
+		(
+			[&strand, &executed, &running, &overlapped, i]()
+			{
+				for (size_t j = 0; j < 1000; j++)
+				{
+					strand.addTask
+					(
+						[&executed, &running, &overlapped, i, j]()
+						{
+							if (running++)
+							{
+								overlapped = true;
+							}
+
+							executed[i].push_back(j);
+
+							running--;
+						},
+						nullptr
+					);
+				}
+			}
+		);
+	}
+
+	for (std::thread& producer : producers)
+	{
+		producer.join();
+	}
+
+	ASSERT_EQ(strand.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+
+	ASSERT_FALSE(overlapped);
+
+	for (const std::vector<size_t>& values : executed)
+	{
+		ASSERT_EQ(values.size(), 1000);
+		ASSERT_TRUE(std::ranges::is_sorted(values));
+	}
+}
+
+TEST(Strand, SharedPool)
+{
+	threading::ThreadPool threadPool(2);
+	std::vector<std::unique_ptr<threading::Strand>> strands;
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::vector<uint64_t> values(16);
+
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		strands.emplace_back(std::make_unique<threading::Strand>(threadPool, 1));
+	}
+
+	for (uint64_t i = 0; i < 100; i++)
+	{
+		for (size_t j = 0; j < strands.size(); j++)
+		{
+			result.emplace_back(strands[j]->addTask([&values, i, j]() { values[j] = values[j] * 2 + i % 2; }, nullptr));
+		}
+	}
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	uint64_t expected = 0;
+
+	for (uint64_t i = 0; i < 100; i++)
+	{
+		expected = expected * 2 + i % 2;
+	}
+
+	ASSERT_TRUE(std::ranges::all_of(values, [expected](uint64_t value) { return value == expected; }));
+}
+
+TEST(Strand, Exception)
+{
+	threading::ThreadPool threadPool(2);
+	threading::Strand strand(threadPool);
+	std::vector<std::unique_ptr<threading::Future>> result;
+
+	std::unique_ptr<threading::Future> failed = strand.addTask([]() -> int { throw std::runtime_error("task"); }, nullptr);
+
+	for (int64_t i = 0; i < 10; i++)
+	{
+		result.emplace_back(strand.addTask(sum, nullptr, i * 10, (i + 1) * 10));
+	}
+
+	ASSERT_THROW(failed->get<int>(), std::runtime_error);
+
+	for (size_t i = 0; i < result.size(); i++)
+	{
+		int64_t left = static_cast<int64_t>(i) * 10;
+
+		ASSERT_EQ(result[i]->get<int64_t>(), sum(left, left + 10));
+	}
+
+	// Strand keeps scheduling drains after exception
+	ASSERT_EQ(strand.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+}
@@ -0,0 +1,89 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+#include "Functions.h"
+
+#include "SubmissionBuffer.h"
+
+using namespace std::chrono_literals;
+
+TEST(SubmissionBuffer, Flush)
+{
+	threading::ThreadPool threadPool(4);
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::atomic_int finished = 0;
+
+	{
+		threading::SubmissionBuffer buffer(threadPool, 16, 0us);
+
+		for (size_t i = 0; i < 40; i++)
+		{
+			result.emplace_back(buffer.addTask([&finished]() { finished++; }));
+		}
+
+		ASSERT_EQ(buffer.size(), 8);
+
+		buffer.flush();
+
+		ASSERT_EQ(buffer.size(), 0);
+
+		result.emplace_back(buffer.addTask(sum, nullptr, 0, 10));
+	}
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_EQ(finished, 40);
+	ASSERT_EQ(result.back()->get<int64_t>(), sum(0, 10));
+}
+
+TEST(SubmissionBuffer, Linger)
+{
+	threading::ThreadPool threadPool(2);
+	threading::SubmissionBuffer buffer(threadPool, 1024, 200us);
+
+	std::unique_ptr<threading::Future> future = buffer.addTask(sum, nullptr, 0, 10);
+
+	ASSERT_EQ(future->get<int64_t>(), sum(0, 10));
+	ASSERT_EQ(buffer.size(), 0);
+}
+
+TEST(SubmissionBuffer, LingerRestart)
+{
+	threading::ThreadPool threadPool(2);
+
+	// Flusher stops with the last buffer and is started again by the next one
+	for (int64_t i = 0; i < 3; i++)
+	{
+		threading::SubmissionBuffer buffer(threadPool, 1024, 200us);
+
+		std::unique_ptr<threading::Future> future = buffer.addTask(sum, nullptr, i, i + 10);
+
+		ASSERT_EQ(future->get<int64_t>(), sum(i, i + 10));
+	}
+}
+
+TEST(SubmissionBuffer, LingerWakesEarlier)
+{
+	threading::ThreadPool threadPool(2);
+	threading::SubmissionBuffer slowBuffer(threadPool, 1024, 10s);
+	threading::SubmissionBuffer fastBuffer(threadPool, 1024, 1ms);
+
+	std::unique_ptr<threading::Future> slowFuture = slowBuffer.addTask(sum, nullptr, 0, 10);
+
+	std::this_thread::sleep_for(10ms);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::unique_ptr<threading::Future> fastFuture = fastBuffer.addTask(sum, nullptr, 0, 10);
+
+	ASSERT_EQ(fastFuture->get<int64_t>(), sum(0, 10));
+	ASSERT_LT(std::chrono::steady_clock::now() - start, 5s);
+	ASSERT_EQ(slowBuffer.size(), 1);
+
+	slowBuffer.flush();
+
+	ASSERT_EQ(slowFuture->get<int64_t>(), sum(0, 10));
+}
@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+
+#include "Functions.h"
+
+#include "TaskGroup.h"
+
+using namespace std::chrono_literals;
+
+TEST(TaskGroup, Wait)
+{
+	threading::ThreadPool threadPool(4);
+	threading::TaskGroup group(threadPool);
+	std::atomic<int64_t> result = 0;
+
+	for (int64_t i = 0; i < 100; i++)
+	{
+		group.addTask([&result, i]() { result += sum(i * 10, (i + 1) * 10); });
+	}
+
+	group.wait();
+
+	ASSERT_EQ(group.getPendingTasks(), 0);
+	ASSERT_EQ(result, sum(0, 1000));
+}
+
+TEST(TaskGroup, MaxConcurrency)
+{
+	threading::ThreadPool threadPool(4);
+	threading::TaskGroup group(threadPool, 1);
+	std::atomic_int current = 0;
+	std::atomic_int max = 0;
+	std::atomic_int otherTasks = 0;
+
+	for (size_t i = 0; i < 8; i++)
+	{
+		group.addTask
+		(
+			[&current, &max]()
+			{
+				int value = ++current;
+				int previous = max;
+
+				while (previous < value && !max.compare_exchange_weak(previous, value));
+
+				std::this_thread::sleep_for(20ms);
+
+				current--;
+			}
+		);
+	}
+
+	// Limited group must not occupy all worker threads
+	threadPool.addTask([&otherTasks]() { otherTasks++; })->wait();
+
+	ASSERT_GT(group.getPendingTasks(), 0);
+
+	group.wait();
+
+	ASSERT_EQ(max, 1);
+	ASSERT_EQ(otherTasks, 1);
+	ASSERT_EQ(group.getMaxConcurrency(), 1);
+}
+
+TEST(TaskGroup, Spawn)
+{
+	threading::ThreadPool threadPool(4);
+	std::vector<int64_t> results(100);
+
+	{
+		threading::TaskGroup group(threadPool);
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			group.spawn(results.data() + i, sum, static_cast<int64_t>(i) * 10, static_cast<int64_t>(i + 1) * 10);
+		}
+
+		group.join();
+	}
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		ASSERT_EQ(results[i], sum(static_cast<int64_t>(i) * 10, static_cast<int64_t>(i + 1) * 10));
+	}
+}
+
+static int64_t recursiveSum(threading::ThreadPool& threadPool, int64_t left, int64_t right)
+{
+	if (right - left <= 1000)
+	{
+		return sum(left, right);
+	}
+
+	int64_t middle = left + (right - left) / 2;
+	int64_t results[2] = {};
+	threading::TaskGroup group(threadPool);
+
+	group.spawn(results, recursiveSum, std::ref(threadPool), left, middle);
+	group.spawn(results + 1, recursiveSum, std::ref(threadPool), middle, right);
+
+	group.join();
+
+	return results[0] + results[1];
+}
+
+TEST(TaskGroup, Nested)
+{
+	threading::ThreadPool threadPool(2);
+
+	ASSERT_EQ(recursiveSum(threadPool, 0, 1'000'000), sum(0, 1'000'000));
+}
+
+TEST(TaskGroup, Exception)
+{
+	threading::ThreadPool threadPool(2);
+
+	for (size_t maxConcurrency : { 0, 1 })
+	{
+		threading::TaskGroup group(threadPool, maxConcurrency);
+		std::atomic_int finished = 0;
+
+		group.spawn([]() { throw std::runtime_error("spawn"); });
+
+		std::unique_ptr<threading::Future> future = group.addTask([]() -> int { throw std::logic_error("task"); }, nullptr);
+
+		for (size_t i = 0; i < 10; i++)
+		{
+			group.spawn([&finished]() { finished++; });
+		}
+
+		try
+		{
+			group.join();
+
+			FAIL();
+		}
+		catch (const std::exception& exception)
+		{
+			ASSERT_TRUE(std::string_view(exception.what()) == "spawn" || std::string_view(exception.what()) == "task");
+		}
+
+		ASSERT_THROW(future->get<int>(), std::logic_error);
+		ASSERT_EQ(group.getPendingTasks(), 0);
+		ASSERT_EQ(finished, 10);
+
+		// Exception is rethrown once, then group is reusable
+		group.spawn([&finished]() { finished++; });
+
+		ASSERT_NO_THROW(group.wait());
+		ASSERT_EQ(finished, 11);
+	}
+}
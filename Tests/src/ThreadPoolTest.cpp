@@ -2,6 +2,9 @@
 
 #include <random>
 #include <chrono>
+#include <fstream>
+#include <numeric>
+#include <map>
 
 #include "Functions.h"
 
@@ -167,3 +170,704 @@ TEST(ThreadPool, LongCalculation)
 
 	ASSERT_TRUE(result == 10);
 }
+
+TEST(ThreadPool, DumpTrace)
+{
+	threading::ThreadPool threadPool(4);
+	std::vector<std::unique_ptr<threading::Future>> result;
+
+	for (int64_t i = 0; i < 100; i++)
+	{
+		result.emplace_back(threadPool.addTask(sum, nullptr, i, i + 10));
+	}
+
+	std::atomic_bool spawned = false;
+
+	result.emplace_back(threadPool.addTask(threading::Label("LabelledTask"), [] {}));
+
+	threadPool.spawn(threading::Label("LabelledSpawn"), [&spawned] { spawned = true; spawned.notify_one(); });
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	spawned.wait(false);
+
+	// Events are recorded after Future is ready
+	while (threadPool.isAnyTaskRunning())
+	{
+		std::this_thread::yield();
+	}
+
+	threadPool.dumpTrace("trace.json");
+
+	std::ifstream trace("trace.json");
+	std::string data((std::istreambuf_iterator<char>(trace)), std::istreambuf_iterator<char>());
+
+	ASSERT_TRUE(data.starts_with(R"({"traceEvents":[)"));
+	ASSERT_TRUE(data.ends_with("]}"));
+
+#ifdef THREAD_POOL_TRACING
+	ASSERT_NE(data.find("CallableTask"), std::string::npos);
+	ASSERT_NE(data.find("LabelledTask"), std::string::npos);
+	ASSERT_NE(data.find("LabelledSpawn"), std::string::npos);
+#endif
+}
+
+TEST(ThreadPool, TraceBufferOverwrite)
+{
+	threading::utility::TraceBuffer buffer(16);
+	std::atomic_bool finished = false;
+
+	std::thread writer([&]()
+		{
+			for (int64_t i = 0; i < 200000; i++)
+			{
+				buffer.record(i % 2 ? "odd" : "even", i, i + 1, i + 2);
+			}
+
+			finished = true;
+		});
+
+	while (!finished)
+	{
+		int64_t previous = -1;
+
+		for (const threading::utility::TraceBuffer::Event& event : buffer.getEvents())
+		{
+			ASSERT_GT(event.enqueueTime, previous);
+			ASSERT_EQ(event.startTime, event.enqueueTime + 1);
+			ASSERT_EQ(event.endTime, event.enqueueTime + 2);
+			ASSERT_STREQ(event.name, event.enqueueTime % 2 ? "odd" : "even");
+
+			previous = event.enqueueTime;
+		}
+	}
+
+	writer.join();
+
+	ASSERT_EQ(buffer.getEvents().size(), 16);
+}
+
+TEST(ThreadPool, AffinityLocality)
+{
+#if defined(_DEBUG) || defined(__VALGRIND__)
+	return;
+#endif
+
+	threading::ThreadPool threadPool(4);
+	std::vector<std::vector<int64_t>> shards(threadPool.size(), std::vector<int64_t>(128 * 1024, 1));
+	std::vector<std::vector<std::thread::id>> executors(shards.size());
+	double withoutAffinity = 0.0;
+	double withAffinity = 0.0;
+	constexpr size_t rounds = 50;
+
+	auto process = [](std::vector<int64_t>& shard)
+		{
+			for (int64_t& value : shard)
+			{
+				value = value * 3 + 1;
+			}
+		};
+
+	auto run = [&](bool affinity)
+		{
+			std::vector<std::unique_ptr<threading::Future>> futures;
+
+			futures.reserve(rounds * shards.size());
+
+			for (size_t round = 0; round < rounds; round++)
+			{
+				for (size_t i = 0; i < shards.size(); i++)
+				{
+					std::function<void()> task = [&process, &shards, &executors, affinity, i]()
+						{
+							process(shards[i]);
+
+							if (affinity)
+							{
+								executors[i].push_back(std::this_thread::get_id());
+							}
+						};
+
+					futures.emplace_back(affinity ? threadPool.addTask(threading::Affinity(i), std::move(task)) : threadPool.addTask(std::move(task)));
+				}
+
+				// Tasks of the same shard must not overlap
+				for (const std::unique_ptr<threading::Future>& future : futures)
+				{
+					future->wait();
+				}
+
+				// Owner that is still busy with previous round lets other workers steal
+				while (threadPool.isAnyTaskRunning())
+				{
+					std::this_thread::yield();
+				}
+
+				futures.clear();
+			}
+		};
+
+	CALCULATE_TIME(run(false), withoutAffinity);
+	CALCULATE_TIME(run(true), withAffinity);
+
+	std::cout << "Without affinity: " << withoutAffinity << 's' << std::endl << "With affinity: " << withAffinity << 's' << std::endl;
+
+	// Every shard has one task per round in mailbox of idle owner, so no task is stolen
+	for (size_t i = 0; i < executors.size(); i++)
+	{
+		ASSERT_EQ(executors[i], std::vector<std::thread::id>(rounds, threadPool.getThreadId(i)));
+	}
+
+	int64_t value = 1;
+
+	for (size_t i = 0; i < rounds * 2; i++)
+	{
+		value = value * 3 + 1;
+	}
+
+	for (const std::vector<int64_t>& shard : shards)
+	{
+		ASSERT_TRUE(std::ranges::all_of(shard, [value](int64_t element) { return element == value; }));
+	}
+
+	ASSERT_EQ(threadPool.getQueuedTasks(), 0);
+}
+
+TEST(ThreadPool, ResizeKeepsQueuedTasks)
+{
+	threading::ThreadPool threadPool(4);
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::atomic_int finished = 0;
+
+	for (size_t i = 0; i < 40; i++)
+	{
+		std::function<void()> task = [&finished]() { std::this_thread::sleep_for(5ms); finished++; };
+
+		result.emplace_back(i % 2 ? threadPool.addTask(std::move(task)) : threadPool.addTask(threading::Affinity(i), std::move(task)));
+	}
+
+	ASSERT_TRUE(threadPool.resize(2));
+	ASSERT_EQ(threadPool.size(), 2);
+
+	threadPool.reinit(false, 3);
+
+	ASSERT_EQ(threadPool.size(), 3);
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_EQ(finished, 40);
+
+	ASSERT_TRUE(threadPool.resize(1));
+
+	ASSERT_EQ(threadPool.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+}
+
+TEST(ThreadPool, ReinitHandsOffQueues)
+{
+	threading::ThreadPool threadPool(4, false, threading::ThreadPool::SubmissionMode::singleProducer);
+	std::atomic_int finished = 0;
+
+	threadPool.setBatchSize(8);
+
+	for (size_t attempt = 0; attempt < 20; attempt++)
+	{
+		std::vector<std::unique_ptr<threading::Future>> result;
+
+		for (size_t i = 0; i < 300; i++)
+		{
+			std::function<void()> task = [&finished]() { finished++; };
+
+			result.emplace_back(i % 3 ? threadPool.addTask(std::move(task)) : threadPool.addTask(threading::Deadline(1s), std::move(task)));
+		}
+
+		// Old workers are stopped while they move batches to their mailboxes
+		threadPool.reinit(false, 2 + attempt % 3);
+
+		for (const std::unique_ptr<threading::Future>& future : result)
+		{
+			future->wait();
+		}
+	}
+
+	ASSERT_EQ(finished, 20 * 300);
+	ASSERT_EQ(threadPool.getQueuedTasks(true), 0);
+}
+
+TEST(ThreadPool, RunPending)
+{
+	threading::ThreadPool threadPool(1);
+	std::atomic_bool blocked = true;
+	std::atomic_int finished = 0;
+	std::vector<std::unique_ptr<threading::Future>> result;
+
+	std::unique_ptr<threading::Future> blocker = threadPool.addTask([&blocked]() { while (blocked); });
+
+	while (!threadPool.isAnyTaskRunning());
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		result.emplace_back(threadPool.addTask([&finished]() { finished++; }));
+	}
+
+	ASSERT_EQ(threadPool.runPending(4), 4);
+	ASSERT_EQ(finished, 4);
+
+	ASSERT_EQ(threadPool.runUntil([&finished]() { return finished == 7; }), 3);
+
+	ASSERT_EQ(threadPool.runFor(10ms), 3);
+	ASSERT_EQ(finished, 10);
+
+	ASSERT_EQ(threadPool.runPending(), 0);
+
+	blocked = false;
+
+	blocker->wait();
+}
+
+TEST(ThreadPool, BatchSize)
+{
+	threading::ThreadPool threadPool(4);
+	std::vector<std::unique_ptr<threading::Future>> result;
+	std::atomic_int finished = 0;
+
+	threadPool.setBatchSize(16);
+
+	ASSERT_EQ(threadPool.getBatchSize(), 16);
+
+	for (size_t i = 0; i < 10000; i++)
+	{
+		result.emplace_back(threadPool.addTask([&finished]() { finished++; }));
+	}
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_EQ(finished, 10000);
+	ASSERT_EQ(threadPool.getQueuedTasks(), 0);
+
+	threadPool.setBatchSize(0);
+
+	ASSERT_EQ(threadPool.getBatchSize(), 1);
+}
+
+TEST(ThreadPool, AddTaskMoveOnly)
+{
+	struct Accumulator
+	{
+		int64_t base;
+
+		int64_t add(std::unique_ptr<int64_t> value) const
+		{
+			return base + *value;
+		}
+	};
+
+	threading::ThreadPool threadPool(2);
+	std::vector<int64_t> buffer(1024 * 1024, 1);
+	const int64_t* data = buffer.data();
+	Accumulator accumulator{ 10 };
+
+	std::unique_ptr<threading::Future> moved = threadPool.addTask
+	(
+		[data](std::vector<int64_t> values) { return values.data() == data ? std::accumulate(values.begin(), values.end(), int64_t(0)) : int64_t(-1); },
+		nullptr,
+		std::move(buffer)
+	);
+	std::unique_ptr<threading::Future> member = threadPool.addTask(&Accumulator::add, nullptr, &accumulator, std::make_unique<int64_t>(5));
+	std::unique_ptr<threading::Future> moveOnlyLambda = threadPool.addTask([value = std::make_unique<int64_t>(7)]() { return *value; }, nullptr);
+
+	ASSERT_EQ(moved->get<int64_t>(), 1024 * 1024);
+	ASSERT_EQ(member->get<int64_t>(), 15);
+	ASSERT_EQ(moveOnlyLambda->get<int64_t>(), 7);
+}
+
+TEST(ThreadPool, ShardedCounters)
+{
+	// Batches move tasks between sharded queues
+	for (size_t batchSize : { 1, 8 })
+	{
+		threading::ThreadPool threadPool(4, true);
+		std::vector<std::thread> producers;
+		std::atomic_int finished = 0;
+
+		threadPool.setBatchSize(batchSize);
+
+		for (size_t i = 0; i < 4; i++)
+		{
+			producers.emplace_back
+			(
+				[&threadPool, &finished]()
+				{
+					for (size_t j = 0; j < 2500; j++)
+					{
+						threadPool.addTask([&finished]() { finished++; }, nullptr);
+					}
+				}
+			);
+		}
+
+		for (std::thread& producer : producers)
+		{
+			producer.join();
+		}
+
+		threadPool.runUntil([&finished]() { return finished == 10000; });
+
+		ASSERT_EQ(threadPool.getQueuedTasks(true), 0);
+		ASSERT_EQ(threadPool.getQueuedTasks(), 0);
+	}
+}
+
+TEST(ThreadPool, Deadline)
+{
+	threading::ThreadPool threadPool(1);
+	std::atomic_bool blocked = true;
+	std::vector<int> order;
+	std::vector<std::unique_ptr<threading::Future>> result;
+
+	threadPool.setExpiredTaskPolicy(threading::ThreadPool::ExpiredTaskPolicy::cancel);
+
+	std::unique_ptr<threading::Future> blocker = threadPool.addTask([&blocked]() { while (blocked); });
+
+	while (!threadPool.isAnyTaskRunning());
+
+	result.emplace_back(threadPool.addTask([&order]() { order.push_back(0); }));
+
+	for (int i = 3; i >= 1; i--)
+	{
+		result.emplace_back(threadPool.addTask(threading::Deadline(i * 1s), [&order, i]() { order.push_back(i); }, nullptr));
+	}
+
+	std::unique_ptr<threading::Future> expired = threadPool.addTask(threading::Deadline(std::chrono::steady_clock::now()), []() { return 1; }, nullptr);
+
+	std::this_thread::sleep_for(1ms);
+
+	blocked = false;
+
+	for (const std::unique_ptr<threading::Future>& future : result)
+	{
+		future->wait();
+	}
+
+	ASSERT_EQ(order, std::vector<int>({ 1, 2, 3, 0 }));
+	ASSERT_THROW(expired->get<int>(), threading::DeadlineExceeded);
+	ASSERT_EQ(threadPool.getExpiredTasks(), 1);
+	ASSERT_EQ(threadPool.getMissedDeadlines(), 1);
+}
+
+TEST(ThreadPool, DeadlineVoidTask)
+{
+	threading::ThreadPool threadPool(1);
+	std::atomic_bool blocked = true;
+	std::atomic_bool executed = false;
+
+	threadPool.setExpiredTaskPolicy(threading::ThreadPool::ExpiredTaskPolicy::cancel);
+
+	std::unique_ptr<threading::Future> blocker = threadPool.addTask([&blocked]() { while (blocked); });
+
+	while (!threadPool.isAnyTaskRunning());
+
+	std::unique_ptr<threading::Future> expired = threadPool.addTask(threading::Deadline(std::chrono::steady_clock::now()), [&executed]() { executed = true; });
+	std::unique_ptr<threading::Future> finished = threadPool.addTask(threading::Deadline(1s), []() {});
+
+	std::this_thread::sleep_for(1ms);
+
+	blocked = false;
+
+	ASSERT_THROW(expired->get<void>(), threading::DeadlineExceeded);
+	ASSERT_NO_THROW(finished->get<void>());
+	ASSERT_FALSE(executed);
+	ASSERT_EQ(threadPool.getExpiredTasks(), 1);
+}
+
+TEST(ThreadPool, BlockingRegion)
+{
+	threading::ThreadPool threadPool(1);
+	std::atomic_bool blocked = true;
+
+	std::unique_ptr<threading::Future> blocker = threadPool.addBlockingTask
+	(
+		[&blocked]()
+		{
+			while (blocked)
+			{
+				std::this_thread::sleep_for(1ms);
+			}
+
+			return 1;
+		},
+		nullptr
+	);
+
+	ASSERT_EQ(threadPool.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+	ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 1);
+
+	{
+		threading::ThreadPool::BlockingRegion region = threadPool.blockingRegion();
+
+		ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 1);
+	}
+
+	blocked = false;
+
+	ASSERT_EQ(blocker->get<int>(), 1);
+	ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 0);
+}
+
+TEST(ThreadPool, BlockingRegionLimit)
+{
+	threading::ThreadPool threadPool(2);
+	std::atomic_bool blocked = true;
+	std::atomic_int entered = 0;
+	std::vector<std::unique_ptr<threading::Future>> blockers;
+
+	auto block = [&blocked, &entered]()
+		{
+			entered++;
+
+			while (blocked)
+			{
+				std::this_thread::sleep_for(1ms);
+			}
+
+			return 1;
+		};
+
+	threadPool.setMaxCompensatingThreads(1);
+
+	blockers.push_back(threadPool.addBlockingTask(block, nullptr));
+	blockers.push_back(threadPool.addBlockingTask(block, nullptr));
+
+	while (entered != 2)
+	{
+		std::this_thread::yield();
+	}
+
+	// Second region gets no thread, first one still keeps thread pool running
+	ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 1);
+	ASSERT_EQ(threadPool.addTask(sum, nullptr, 0, 10)->get<int64_t>(), sum(0, 10));
+
+	blocked = false;
+
+	for (const std::unique_ptr<threading::Future>& future : blockers)
+	{
+		ASSERT_EQ(future->get<int>(), 1);
+	}
+
+	ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 0);
+
+	// Stopped thread counts against limit until it leaves or is reused
+	blocked = true;
+
+	blockers.push_back(threadPool.addBlockingTask(block, nullptr));
+
+	while (entered != 3)
+	{
+		std::this_thread::yield();
+	}
+
+	ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 1);
+
+	blocked = false;
+
+	ASSERT_EQ(blockers.back()->get<int>(), 1);
+
+	threadPool.shutdown();
+
+	ASSERT_EQ(threadPool.getCompensatingThreadsCount(), 0);
+}
+
+TEST(ThreadPool, SingleProducer)
+{
+	threading::ThreadPool threadPool(4, false, threading::ThreadPool::SubmissionMode::singleProducer);
+	std::atomic<int64_t> result = 0;
+	std::vector<std::thread> producers;
+
+	// Ring overflows and other producers go to shared queue
+	for (size_t i = 0; i < 4; i++)
+	{
+		producers.emplace_back
+		(
+			[&threadPool, &result, i]()
+			{
+				if (!i)
+				{
+					threadPool.bindProducer();
+				}
+
+				for (int64_t j = 0; j < 100'000; j++)
+				{
+					threadPool.addTask([&result, j]() { result += j; }, nullptr);
+				}
+			}
+		);
+	}
+
+	for (std::thread& producer : producers)
+	{
+		producer.join();
+	}
+
+	threadPool.shutdown();
+
+	ASSERT_EQ(result, sum(0, 100'000) * 4);
+	ASSERT_EQ(threadPool.getQueuedTasks(true), 0);
+}
+
+TEST(ThreadPool, SingleProducerRing)
+{
+	threading::ThreadPool threadPool(1, false, threading::ThreadPool::SubmissionMode::singleProducer);
+	std::atomic_bool blocked = true;
+	std::atomic_size_t finished = 0;
+	size_t added = 0;
+	auto addTask = [&threadPool, &finished, &added]() { threadPool.addTask([&finished]() { finished++; }, nullptr); added++; };
+
+	// Thread that constructs ThreadPool is producer
+	threadPool.addTask([&blocked]() { while (blocked); }, nullptr);
+
+	while (!threadPool.isAnyTaskRunning());
+
+	for (size_t i = 0; i < 10; i++)
+	{
+		addTask();
+	}
+
+	ASSERT_EQ(threadPool.getRingTasks(), 10);
+	ASSERT_EQ(threadPool.getQueuedTasks(true), 10);
+
+	std::thread(addTask).join();
+
+	ASSERT_EQ(threadPool.getRingTasks(), 10);
+	ASSERT_EQ(threadPool.getQueuedTasks(true), 11);
+
+	// Bound thread becomes producer instead of calling thread
+	std::thread([&threadPool, &addTask]() { threadPool.bindProducer(); addTask(); }).join();
+
+	addTask();
+
+	ASSERT_EQ(threadPool.getRingTasks(), 11);
+	ASSERT_EQ(threadPool.getQueuedTasks(true), 13);
+
+	threadPool.bindProducer();
+
+	// Tasks over ring capacity go to shared queue
+	while (added < threading::ThreadPool::submissionRingCapacity + 10)
+	{
+		addTask();
+	}
+
+	ASSERT_EQ(threadPool.getRingTasks(), threading::ThreadPool::submissionRingCapacity);
+	ASSERT_EQ(threadPool.getQueuedTasks(true), added);
+
+	blocked = false;
+
+	threadPool.shutdown();
+
+	ASSERT_EQ(finished, added);
+	ASSERT_EQ(threadPool.getRingTasks(), 0);
+}
+
+TEST(ThreadPool, SingleProducerSubmitCost)
+{
+#if defined(_DEBUG) || defined(__VALGRIND__)
+	return;
+#endif
+
+	constexpr size_t tasksCount = 50'000;
+	std::map<threading::ThreadPool::SubmissionMode, std::chrono::nanoseconds> submitTimes;
+
+	for (threading::ThreadPool::SubmissionMode mode : { threading::ThreadPool::SubmissionMode::multipleProducers, threading::ThreadPool::SubmissionMode::singleProducer })
+	{
+		std::chrono::nanoseconds best = std::chrono::nanoseconds::max();
+
+		for (size_t attempt = 0; attempt < 5; attempt++)
+		{
+			threading::ThreadPool threadPool(1, false, mode);
+			std::atomic_bool blocked = true;
+			std::vector<std::unique_ptr<threading::Future>> result;
+
+			result.reserve(tasksCount);
+
+			threadPool.addTask([&blocked]() { while (blocked) std::this_thread::yield(); }, nullptr);
+
+			while (!threadPool.isAnyTaskRunning());
+
+			// Busy worker doesn't wait for token, so ring tasks are added without queue lock and semaphore release
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			for (size_t i = 0; i < tasksCount; i++)
+			{
+				result.emplace_back(threadPool.addTask([]() {}, nullptr));
+			}
+
+			best = (std::min)(best, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+
+			blocked = false;
+		}
+
+		submitTimes[mode] = best;
+	}
+
+	std::cout << "submit of " << tasksCount << " tasks multipleProducers: " << submitTimes[threading::ThreadPool::SubmissionMode::multipleProducers].count()
+		<< "ns singleProducer: " << submitTimes[threading::ThreadPool::SubmissionMode::singleProducer].count() << "ns" << std::endl;
+
+	ASSERT_LT(submitTimes[threading::ThreadPool::SubmissionMode::singleProducer], submitTimes[threading::ThreadPool::SubmissionMode::multipleProducers]);
+}
+
+TEST(ThreadPool, SubmitLatency)
+{
+	// Informational only, latency depends on machine load and is not asserted
+	constexpr size_t samplesCount = 20'000;
+
+	for (threading::ThreadPool::SubmissionMode mode : { threading::ThreadPool::SubmissionMode::multipleProducers, threading::ThreadPool::SubmissionMode::singleProducer })
+	{
+		threading::ThreadPool threadPool(2, false, mode);
+		std::vector<int64_t> latencies(samplesCount);
+
+		for (size_t i = 0; i < samplesCount; i++)
+		{
+			std::chrono::steady_clock::time_point submitTime = std::chrono::steady_clock::now();
+
+			threadPool.addTask([&latencies, submitTime, i]() { latencies[i] = (std::chrono::steady_clock::now() - submitTime).count(); }, nullptr);
+
+			// Spacing keeps queue short, so latency is not dominated by waiting behind previous tasks
+			while (std::chrono::steady_clock::now() - submitTime < 5us)
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		threadPool.shutdown();
+
+		std::ranges::sort(latencies);
+
+		std::cout << (mode == threading::ThreadPool::SubmissionMode::singleProducer ? "singleProducer" : "multipleProducers")
+			<< " submit to start p50: " << latencies[samplesCount / 2]
+			<< "ns p99: " << latencies[samplesCount * 99 / 100]
+			<< "ns p999: " << latencies[samplesCount * 999 / 1000] << "ns" << std::endl;
+	}
+}
+
+TEST(ThreadPool, ResultCallback)
+{
+	threading::ThreadPool threadPool(2);
+	std::atomic_bool received = false;
+
+	threadPool.addTask
+	(
+		[]() { return std::make_unique<int>(5); },
+		[&received](std::unique_ptr<int>&& value) { received = *value == 5; }
+	);
+
+	threadPool.shutdown();
+
+	ASSERT_TRUE(received);
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+namespace threading
+{
+	/// @brief Thrown from Future of task that AdmissionController didn't add to ThreadPool
+	class THREAD_POOL_API AdmissionRejected : public std::runtime_error
+	{
+	public:
+		enum class Reason
+		{
+			/// @brief Max number of tasks in flight was reached
+			maxInFlight,
+			/// @brief Queue wait time stayed above target delay
+			targetDelay
+		};
+
+	private:
+		Reason reason;
+
+	public:
+		AdmissionRejected(Reason reason);
+
+		/**
+		 * @brief Getter for reason
+		 * @return
+		 */
+		Reason getReason() const;
+	};
+
+	/**
+	 * @brief Adds tasks to ThreadPool only while it is not saturated, so queue wait time stays bounded under load spikes
+	 * @details Wait time check follows CoDel: when every task waited in queue longer than target delay during interval, controller enters dropping state.
+	 * In dropping state one task is shed at interval / sqrt(n) after n-th shed task and tasks between drops are admitted, until some task waits less than target delay or all tasks are finished.
+	 * Future of refused task is ready immediately and throws AdmissionRejected
+	 */
+	class THREAD_POOL_API AdmissionController final
+	{
+	private:
+		struct State
+		{
+			std::chrono::nanoseconds targetDelay;
+			std::chrono::nanoseconds interval;
+			size_t maxInFlight;
+			std::atomic_size_t inFlightTasks;
+			std::atomic_size_t queuedTasks;
+			std::atomic_size_t acceptedTasks;
+			std::atomic_size_t rejectedTasks;
+			std::atomic_size_t shedTasks;
+			/// @brief Moving averages in nanoseconds and tasks
+			std::atomic<double> averageWaitTime;
+			std::atomic<double> averageQueueDepth;
+			/// @brief Time since epoch in nanoseconds when wait time above target starts shedding(0 while wait time is below target)
+			std::atomic<int64_t> firstAboveTime;
+			/// @brief Time since epoch in nanoseconds of next shed task in dropping state
+			std::atomic<int64_t> dropNext;
+			/// @brief Number of shed tasks since dropping state started
+			std::atomic_size_t dropCount;
+			std::atomic_bool dropping;
+
+			State(std::chrono::nanoseconds targetDelay, std::chrono::nanoseconds interval, size_t maxInFlight);
+
+			/// @brief Update statistics when task leaves queue
+			void start(std::chrono::nanoseconds waitTime);
+
+			/// @brief Check drop schedule in dropping state
+			/// @return true if task must be shed now
+			bool drop();
+
+			void finish();
+		};
+
+		class AdmissionTask;
+
+	private:
+		ThreadPool& threadPool;
+		std::shared_ptr<State> state;
+
+	private:
+		static void updateAverage(std::atomic<double>& average, double value);
+
+	private:
+		std::unique_ptr<Future> addTask(std::unique_ptr<BaseTask>&& task);
+
+	public:
+		/**
+		 * @brief Construct AdmissionController
+		 * @param threadPool ThreadPool that executes admitted tasks
+		 * @param targetDelay Acceptable queue wait time(0 disables wait time check)
+		 * @param interval How long wait time must stay above target before tasks are shed
+		 * @param maxInFlight Max number of admitted tasks that are queued or running(0 means no limit)
+		 */
+		AdmissionController(ThreadPool& threadPool, std::chrono::microseconds targetDelay = std::chrono::milliseconds(5), std::chrono::microseconds interval = std::chrono::milliseconds(100), size_t maxInFlight = 0);
+
+		AdmissionController(const AdmissionController&) = delete;
+
+		AdmissionController& operator =(const AdmissionController&) = delete;
+
+		/// @brief Add new task to thread pool if it is not saturated
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to thread pool if it is not saturated
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, std::function<void()>&& callback);
+
+		/// @brief Add new task to thread pool if it is not saturated
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to thread pool if it is not saturated
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, std::function<void()>&& callback);
+
+		/**
+		 * @brief Add new task to thread pool if it is not saturated
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to thread pool if it is not saturated
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to thread pool if it is not saturated
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Args&&... args);
+
+		/**
+		 * @brief Get number of tasks that were added to ThreadPool
+		 * @return
+		 */
+		size_t getAcceptedTasks() const;
+
+		/**
+		 * @brief Get number of tasks refused because of maxInFlight
+		 * @return
+		 */
+		size_t getRejectedTasks() const;
+
+		/**
+		 * @brief Get number of tasks refused because queue wait time stayed above target delay
+		 * @return
+		 */
+		size_t getShedTasks() const;
+
+		/**
+		 * @brief Get number of admitted tasks that are queued or running
+		 * @return
+		 */
+		size_t getInFlightTasks() const;
+
+		/**
+		 * @brief Get moving average of time admitted tasks waited in queue
+		 * @return
+		 */
+		std::chrono::nanoseconds getAverageWaitTime() const;
+
+		/**
+		 * @brief Get moving average of admitted tasks waiting in queue, sampled on every addTask
+		 * @return
+		 */
+		double getAverageQueueDepth() const;
+
+		/**
+		 * @brief Getter for targetDelay
+		 * @return
+		 */
+		std::chrono::nanoseconds getTargetDelay() const;
+
+		/**
+		 * @brief Getter for maxInFlight
+		 * @return 0 if number of tasks is not limited
+		 */
+		size_t getMaxInFlight() const;
+
+		/**
+		 * @brief Admitted tasks keep running after AdmissionController is destroyed
+		 */
+		~AdmissionController() = default;
+	};
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> AdmissionController::addTask(F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...)
+		);
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> AdmissionController::addTask(F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...)
+		);
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> AdmissionController::addTask(Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<TaskT>(std::forward<Args>(args)...)
+		);
+	}
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+
+#include "ThreadPoolPolicies.h"
+
+namespace threading
+{
+	/**
+	 * @brief Header-only thread pool configured at compile time
+	 * @tparam QueuePolicy Provides Queue<TaskStorage> with push, pop and size
+	 * @tparam IdlePolicy What worker does when queue is empty
+	 * @tparam TaskStorage Move constructible callable without arguments that stores task
+	 * @tparam MetricsPolicy Receives onSubmit and onExecute events
+	 */
+	template
+	<
+		typename QueuePolicy = policies::MutexQueue,
+		typename IdlePolicy = policies::BlockingIdle,
+		typename TaskStorage = policies::FunctionStorage,
+		typename MetricsPolicy = policies::NoMetrics
+	>
+	class BasicThreadPool final
+	{
+	private:
+		typename QueuePolicy::template Queue<TaskStorage> tasks;
+		IdlePolicy idle;
+		MetricsPolicy metrics;
+		std::atomic_bool running;
+		std::vector<std::thread> workers;
+
+	private:
+		void workerThread();
+
+	public:
+		/// @brief Construct BasicThreadPool
+		/// @param threadCount Number of threads in BasicThreadPool(default is max threads for current hardware)
+		BasicThreadPool(size_t threadsCount = std::thread::hardware_concurrency());
+
+		BasicThreadPool(const BasicThreadPool&) = delete;
+
+		BasicThreadPool& operator =(const BasicThreadPool&) = delete;
+
+		/**
+		 * @brief Try to add new task
+		 * @return false if queue is full
+		 */
+		template<typename F> requires std::constructible_from<TaskStorage, F&&>
+		bool tryAddTask(F&& task);
+
+		/**
+		 * @brief Add new task. Yields while queue is full
+		 */
+		template<typename F> requires std::constructible_from<TaskStorage, F&&>
+		void addTask(F&& task);
+
+		/**
+		 * @brief Execute all queued tasks and stop worker threads
+		 */
+		void shutdown();
+
+		/// @brief Getter for threadsCount
+		/// @return Current count of threads in thread pool
+		size_t size() const;
+
+		/**
+		 * @brief Get queued tasks
+		 * @return
+		 */
+		size_t getQueuedTasks() const;
+
+		/**
+		 * @brief Getter for metrics
+		 * @return
+		 */
+		const MetricsPolicy& getMetrics() const;
+
+		~BasicThreadPool();
+	};
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::workerThread()
+	{
+		while (true)
+		{
+			if (std::optional<TaskStorage> task = tasks.pop())
+			{
+				(*task)();
+
+				metrics.onExecute();
+
+				continue;
+			}
+
+			if (!running)
+			{
+				break;
+			}
+
+			idle.wait([this]() { return tasks.size() || !running; });
+		}
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::BasicThreadPool(size_t threadsCount) :
+		running(true)
+	{
+		workers.reserve(threadsCount);
+
+		for (size_t i = 0; i < threadsCount; i++)
+		{
+			workers.emplace_back(&BasicThreadPool::workerThread, this);
+		}
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	template<typename F> requires std::constructible_from<TaskStorage, F&&>
+	bool BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::tryAddTask(F&& task)
+	{
+		TaskStorage storage(std::forward<F>(task));
+
+		if (!tasks.push(std::move(storage)))
+		{
+			return false;
+		}
+
+		metrics.onSubmit();
+
+		idle.notify();
+
+		return true;
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	template<typename F> requires std::constructible_from<TaskStorage, F&&>
+	void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::addTask(F&& task)
+	{
+		TaskStorage storage(std::forward<F>(task));
+
+		while (!tasks.push(std::move(storage)))
+		{
+			std::this_thread::yield();
+		}
+
+		metrics.onSubmit();
+
+		idle.notify();
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	void BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::shutdown()
+	{
+		running = false;
+
+		idle.notifyAll();
+
+		for (std::thread& worker : workers)
+		{
+			if (worker.joinable())
+			{
+				worker.join();
+			}
+		}
+
+		workers.clear();
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	size_t BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::size() const
+	{
+		return workers.size();
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	size_t BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::getQueuedTasks() const
+	{
+		return tasks.size();
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	const MetricsPolicy& BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::getMetrics() const
+	{
+		return metrics;
+	}
+
+	template<typename QueuePolicy, typename IdlePolicy, typename TaskStorage, typename MetricsPolicy>
+	BasicThreadPool<QueuePolicy, IdlePolicy, TaskStorage, MetricsPolicy>::~BasicThreadPool()
+	{
+		this->shutdown();
+	}
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <source_location>
+#include <exception>
+
+#include "TaskGroup.h"
+
+namespace threading
+{
+	/// @brief How iterations of parallelFor are split between participants
+	enum class LoopSchedule
+	{
+		/// @brief Equal contiguous blocks, or chunks assigned round robin if chunkSize is set. Same as OpenMP static
+		fixed,
+		/// @brief Participants take next chunk from shared counter. Same as OpenMP dynamic
+		dynamic,
+		/// @brief Chunks shrink with remaining iterations down to chunkSize. Same as OpenMP guided
+		guided,
+		/// @brief Dynamic schedule with chunk size tuned by timings of previous calls from same call site
+		tuned
+	};
+
+	/// @brief Statistics of one parallelFor call
+	struct LoopStatistics
+	{
+		/// @brief Chunks executed by every participant of loop
+		std::vector<size_t> chunks;
+		/// @brief Iterations executed by every participant of loop
+		std::vector<size_t> iterations;
+		/// @brief Time every participant of loop spent from its first chunk to its last
+		std::vector<std::chrono::nanoseconds> busyTime;
+		/// @brief Max busy time divided by mean busy time(1 means perfectly balanced loop)
+		double imbalance;
+		/// @brief Chunk size that was used(0 for equal blocks)
+		size_t chunkSize;
+		/// @brief Time from start of loop to its end
+		std::chrono::nanoseconds time;
+	};
+
+	/// @brief Chooses chunk size for tuned loops by timings recorded per call site
+	class THREAD_POOL_API LoopTuner final
+	{
+	public:
+		/**
+		 * @brief Get chunk size for next loop of call site
+		 * @details Every distinct candidate from iterations / participants down to 1/256 of it is tried twice, then fastest per iteration is used for all following loops of call site
+		 */
+		static size_t getChunkSize(const std::source_location& location, size_t iterations, size_t participants);
+
+		/// @brief Record time of loop that used chunk size given by getChunkSize
+		static void record(const std::source_location& location, size_t iterations, size_t participants, size_t chunkSize, std::chrono::nanoseconds time);
+
+		/// @brief Forget timings of all call sites
+		static void reset();
+	};
+
+	/**
+	 * @brief Execute body for every index in [begin, end) on worker threads of ThreadPool. Calling thread executes queued tasks of ThreadPool until loop is finished
+	 * @param body Called with index
+	 * @param schedule How iterations are split between participants. There is one participant per worker thread
+	 * @param chunkSize Iterations per chunk. 0 means equal blocks for fixed schedule and 1 for dynamic and guided. Ignored by tuned schedule
+	 * @param location Call site that tuned schedule keys its timings by
+	 * @return Statistics of loop
+	 * @exception Rethrows first exception of body. Chunks that were not started are skipped
+	 */
+	template<std::integral IndexT, typename F> requires std::invocable<F&, IndexT>
+	LoopStatistics parallelFor
+	(
+		ThreadPool& threadPool,
+		IndexT begin,
+		IndexT end,
+		F&& body,
+		LoopSchedule schedule = LoopSchedule::fixed,
+		size_t chunkSize = 0,
+		const std::source_location& location = std::source_location::current()
+	);
+
+	template<std::integral IndexT, typename F> requires std::invocable<F&, IndexT>
+	LoopStatistics parallelFor(ThreadPool& threadPool, IndexT begin, IndexT end, F&& body, LoopSchedule schedule, size_t chunkSize, const std::source_location& location)
+	{
+		LoopStatistics result = {};
+		size_t iterations = end > begin ? static_cast<size_t>(end - begin) : 0;
+		size_t participants = (std::min)((std::max)(threadPool.getThreadsCount(), static_cast<size_t>(1)), (std::max)(iterations, static_cast<size_t>(1)));
+		std::atomic_size_t next = 0;
+		std::exception_ptr exception;
+		std::mutex exceptionMutex;
+
+		switch (schedule)
+		{
+		case LoopSchedule::fixed:
+			break;
+
+		case LoopSchedule::tuned:
+			chunkSize = LoopTuner::getChunkSize(location, iterations, participants);
+
+			break;
+
+		default:
+			chunkSize = (std::max)(chunkSize, static_cast<size_t>(1));
+
+			break;
+		}
+
+		result.chunks.resize(participants);
+		result.iterations.resize(participants);
+		result.busyTime.resize(participants);
+		result.chunkSize = chunkSize;
+
+		// Return next chunk of participant as [first, last) offsets from begin or false if loop is over
+		auto nextChunk = [&](size_t participant, size_t chunk, size_t& first, size_t& last) -> bool
+			{
+				if (schedule == LoopSchedule::fixed)
+				{
+					if (!chunkSize)
+					{
+						first = iterations * participant / participants;
+						last = iterations * (participant + 1) / participants;
+
+						return !chunk && first < last && next < iterations;
+					}
+
+					first = (chunk * participants + participant) * chunkSize;
+					last = (std::min)(first + chunkSize, iterations);
+
+					return first < iterations && next < iterations;
+				}
+
+				if (schedule == LoopSchedule::guided)
+				{
+					size_t current = next;
+
+					do
+					{
+						if (current >= iterations)
+						{
+							return false;
+						}
+
+						last = current + (std::max)((iterations - current + participants - 1) / participants, chunkSize);
+					} while (!next.compare_exchange_weak(current, (std::min)(last, iterations)));
+
+					first = current;
+					last = (std::min)(last, iterations);
+
+					return true;
+				}
+
+				first = next.fetch_add(chunkSize);
+				last = (std::min)(first + chunkSize, iterations);
+
+				return first < iterations;
+			};
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		{
+			TaskGroup group(threadPool);
+
+			for (size_t participant = 0; participant < participants; participant++)
+			{
+				group.spawn
+				(
+					[&, participant]()
+					{
+						std::chrono::steady_clock::time_point participantStart = std::chrono::steady_clock::now();
+						size_t first = 0;
+						size_t last = 0;
+
+						while (nextChunk(participant, result.chunks[participant], first, last))
+						{
+							try
+							{
+								for (size_t i = first; i < last; i++)
+								{
+									body(static_cast<IndexT>(begin + static_cast<IndexT>(i)));
+								}
+							}
+							catch (...)
+							{
+								std::lock_guard<std::mutex> lock(exceptionMutex);
+
+								if (!exception)
+								{
+									exception = std::current_exception();
+								}
+
+								// Fixed schedule checks counter too, so no participant starts new chunk
+								next = iterations;
+							}
+
+							result.chunks[participant]++;
+							result.iterations[participant] += last - first;
+						}
+
+						result.busyTime[participant] = std::chrono::steady_clock::now() - participantStart;
+					}
+				);
+			}
+
+			group.join();
+		}
+
+		result.time = std::chrono::steady_clock::now() - start;
+
+		std::chrono::nanoseconds maxBusyTime = *std::ranges::max_element(result.busyTime);
+		std::chrono::nanoseconds totalBusyTime = std::chrono::nanoseconds::zero();
+
+		for (std::chrono::nanoseconds busyTime : result.busyTime)
+		{
+			totalBusyTime += busyTime;
+		}
+
+		result.imbalance = totalBusyTime.count() ? static_cast<double>(maxBusyTime.count()) * participants / totalBusyTime.count() : 1.0;
+
+		if (schedule == LoopSchedule::tuned)
+		{
+			LoopTuner::record(location, iterations, participants, chunkSize, result.time);
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+
+		return result;
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+namespace threading
+{
+	/**
+	 * @brief Logical executor with own queue that runs tasks on worker threads of ThreadPool
+	 */
+	class THREAD_POOL_API Partition final
+	{
+	private:
+		struct State
+		{
+			ThreadPool& threadPool;
+			utility::ConcurrentQueue<std::unique_ptr<BaseTask>> tasks;
+			std::atomic_size_t scheduledDrains;
+			size_t weight;
+			size_t maxConcurrency;
+
+			State(ThreadPool& threadPool, size_t weight, size_t maxConcurrency);
+		};
+
+		class DrainTask;
+
+	private:
+		std::shared_ptr<State> state;
+
+	private:
+		static void schedule(const std::shared_ptr<State>& state);
+
+		static void drain(const std::shared_ptr<State>& state);
+
+	private:
+		void enqueue(std::unique_ptr<BaseTask>&& task);
+
+		std::unique_ptr<Future> addTask(std::unique_ptr<BaseTask>&& task);
+
+	public:
+		/**
+		 * @brief Construct Partition
+		 * @param threadPool ThreadPool that executes tasks of this partition
+		 * @param weight How many tasks partition executes each time it gets worker thread
+		 * @param maxConcurrency Max number of tasks of this partition that run at the same time(0 means threads count of ThreadPool)
+		 */
+		Partition(ThreadPool& threadPool, size_t weight = 1, size_t maxConcurrency = 0);
+
+		/// @brief Add new task to partition
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to partition
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, std::function<void()>&& callback);
+
+		/// @brief Add new task to partition
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to partition
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, std::function<void()>&& callback);
+
+		/**
+		 * @brief Add new task to partition
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues. Move only arguments are supported
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to partition
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to partition
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Args&&... args);
+
+		/**
+		 * @brief Get tasks that wait execution in this partition
+		 * @return
+		 */
+		size_t getQueuedTasks() const;
+
+		/**
+		 * @brief Getter for weight
+		 * @return
+		 */
+		size_t getWeight() const;
+
+		/**
+		 * @brief Getter for maxConcurrency
+		 * @return 0 if partition limited only by threads count of ThreadPool
+		 */
+		size_t getMaxConcurrency() const;
+
+		~Partition() = default;
+
+		friend class TaskGroup;
+	};
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> Partition::addTask(F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...)
+		);
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> Partition::addTask(F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...)
+		);
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> Partition::addTask(Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<TaskT>(std::forward<Args>(args)...)
+		);
+	}
+}
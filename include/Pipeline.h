@@ -0,0 +1,488 @@
+#pragma once
+
+#include <map>
+#include <exception>
+
+#include "ThreadPool.h"
+
+namespace threading
+{
+	/// @brief Statistics of one stage of Pipeline
+	struct PipelineStageStatistics
+	{
+		/// @brief Items processed by stage during all runs
+		uint64_t processedItems;
+		/// @brief Total time spent in stage function by all threads
+		std::chrono::nanoseconds busyTime;
+		/// @brief Items per second processed by stage during last run
+		double throughput;
+	};
+
+	/**
+	 * @brief Chain of stages that process stream of items on worker threads of ThreadPool
+	 * @details Number of items in flight is limited by tokens, so memory doesn't grow between stages.
+	 * Thread that finished stage continues same item in next stage. Item that can't enter stage is parked and continued by thread that leaves that stage
+	 * @tparam T Item type. Items are reused between tokens, so source assigns every field it needs
+	 */
+	template<std::default_initializable T>
+	class Pipeline final
+	{
+	private:
+		struct Item
+		{
+			size_t sequence;
+			T value;
+			/// @brief Some stage threw on this item, remaining stages skip it
+			bool failed;
+		};
+
+		struct Stage
+		{
+			std::function<void(T&)> function;
+			bool serial;
+			size_t maxConcurrency;
+			std::mutex waitingMutex;
+			/// @brief Parked items ordered by sequence
+			std::map<size_t, Item*> waitingItems;
+			size_t nextSequence;
+			size_t runningItems;
+			std::atomic_uint64_t processedItems;
+			std::atomic<int64_t> busyTime;
+			uint64_t lastRunItems;
+
+			Stage(std::function<void(T&)>&& function, bool serial, size_t maxConcurrency);
+
+			/// @brief Enter stage or park item
+			bool tryEnter(Item* item);
+
+			/// @brief Leave stage
+			/// @return Parked item that entered stage instead
+			Item* leave();
+		};
+
+		class ItemTask;
+
+	private:
+		ThreadPool& threadPool;
+		std::vector<std::unique_ptr<Stage>> stages;
+		std::vector<std::unique_ptr<Item>> items;
+		std::function<bool(T&)> source;
+		std::mutex sourceMutex;
+		size_t nextSequence;
+		bool sourceFinished;
+		std::atomic_size_t activeTokens;
+		std::exception_ptr exception;
+		std::mutex exceptionMutex;
+		std::chrono::nanoseconds lastRunTime;
+
+	private:
+		/// @brief Remember first exception and stop reading source
+		void fail(std::exception_ptr exception);
+
+		/// @brief Take next item from source into item
+		/// @return false if source is finished
+		bool read(Item* item);
+
+		/// @brief Carry item through stages starting from stageIndex, then through new items while source has them
+		/// @param entered Item already entered stage with stageIndex
+		void process(Item* item, size_t stageIndex, bool entered);
+
+	public:
+		/**
+		 * @brief Construct Pipeline
+		 * @param threadPool ThreadPool that executes stages
+		 * @param maxTokens Max number of items in flight between source and last stage
+		 */
+		Pipeline(ThreadPool& threadPool, size_t maxTokens = std::thread::hardware_concurrency() * 4);
+
+		Pipeline(const Pipeline&) = delete;
+
+		Pipeline& operator =(const Pipeline&) = delete;
+
+		/**
+		 * @brief Add stage that processes one item at a time in source order
+		 * @param function Called with item
+		 */
+		void addSerialStage(const std::function<void(T&)>& function);
+
+		/**
+		 * @brief Add stage that processes items concurrently in any order
+		 * @param function Called with item
+		 * @param maxConcurrency Max number of items in stage at the same time(0 means limited only by tokens)
+		 */
+		void addParallelStage(const std::function<void(T&)>& function, size_t maxConcurrency = 0);
+
+		/**
+		 * @brief Process all items of source and wait for them. Calling thread executes queued tasks of ThreadPool meanwhile
+		 * @param source Called serially. Assigns next item and returns true, or returns false when input is over
+		 * @exception Rethrows first exception of source or stage. Items that were in flight are finished, no new items are read
+		 */
+		void run(const std::function<bool(T&)>& source);
+
+		/**
+		 * @brief Get statistics of stage
+		 * @param stageIndex Index of stage in adding order
+		 * @return
+		 * @exception std::out_of_range
+		 */
+		PipelineStageStatistics getStageStatistics(size_t stageIndex) const;
+
+		/**
+		 * @brief Get number of stages
+		 * @return
+		 */
+		size_t getStagesCount() const;
+
+		/**
+		 * @brief Getter for maxTokens
+		 * @return
+		 */
+		size_t getMaxTokens() const;
+
+		~Pipeline() = default;
+	};
+
+	template<std::default_initializable T>
+	class Pipeline<T>::ItemTask : public BaseTask
+	{
+	private:
+		Pipeline& pipeline;
+		Item* item;
+		size_t stageIndex;
+		bool entered;
+
+	protected:
+		void executeImplementation() override;
+
+		std::unique_ptr<Promise> createTaskPromise() const override;
+
+	public:
+		ItemTask(Pipeline& pipeline, Item* item, size_t stageIndex, bool entered);
+
+		void execute() override;
+
+		std::string_view getName() const override;
+
+		~ItemTask() = default;
+	};
+
+	template<std::default_initializable T>
+	void Pipeline<T>::ItemTask::executeImplementation()
+	{
+		pipeline.process(item, stageIndex, entered);
+	}
+
+	template<std::default_initializable T>
+	std::unique_ptr<Promise> Pipeline<T>::ItemTask::createTaskPromise() const
+	{
+		return nullptr;
+	}
+
+	template<std::default_initializable T>
+	Pipeline<T>::ItemTask::ItemTask(Pipeline& pipeline, Item* item, size_t stageIndex, bool entered) :
+		pipeline(pipeline),
+		item(item),
+		stageIndex(stageIndex),
+		entered(entered)
+	{
+
+	}
+
+	template<std::default_initializable T>
+	void Pipeline<T>::ItemTask::execute()
+	{
+		this->executeImplementation();
+	}
+
+	template<std::default_initializable T>
+	std::string_view Pipeline<T>::ItemTask::getName() const
+	{
+		return "Pipeline";
+	}
+
+	template<std::default_initializable T>
+	Pipeline<T>::Stage::Stage(std::function<void(T&)>&& function, bool serial, size_t maxConcurrency) :
+		function(std::move(function)),
+		serial(serial),
+		maxConcurrency(serial ? 1 : maxConcurrency),
+		nextSequence(0),
+		runningItems(0),
+		processedItems(0),
+		busyTime(0),
+		lastRunItems(0)
+	{
+
+	}
+
+	template<std::default_initializable T>
+	bool Pipeline<T>::Stage::tryEnter(Item* item)
+	{
+		if (!maxConcurrency)
+		{
+			return true;
+		}
+
+		std::lock_guard<std::mutex> lock(waitingMutex);
+
+		if (serial ? (!runningItems && item->sequence == nextSequence) : runningItems < maxConcurrency)
+		{
+			runningItems++;
+
+			return true;
+		}
+
+		waitingItems.emplace(item->sequence, item);
+
+		return false;
+	}
+
+	template<std::default_initializable T>
+	typename Pipeline<T>::Item* Pipeline<T>::Stage::leave()
+	{
+		if (!maxConcurrency)
+		{
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(waitingMutex);
+
+		runningItems--;
+
+		if (serial)
+		{
+			nextSequence++;
+		}
+
+		if (waitingItems.empty() || (serial && waitingItems.begin()->first != nextSequence))
+		{
+			return nullptr;
+		}
+
+		Item* result = waitingItems.begin()->second;
+
+		waitingItems.erase(waitingItems.begin());
+
+		runningItems++;
+
+		return result;
+	}
+
+	template<std::default_initializable T>
+	void Pipeline<T>::fail(std::exception_ptr exception)
+	{
+		{
+			std::lock_guard<std::mutex> lock(exceptionMutex);
+
+			if (!this->exception)
+			{
+				this->exception = exception;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(sourceMutex);
+
+		sourceFinished = true;
+	}
+
+	template<std::default_initializable T>
+	bool Pipeline<T>::read(Item* item)
+	{
+		std::lock_guard<std::mutex> lock(sourceMutex);
+
+		if (sourceFinished)
+		{
+			return false;
+		}
+
+		try
+		{
+			sourceFinished = !source(item->value);
+		}
+		catch (...)
+		{
+			sourceFinished = true;
+
+			std::lock_guard<std::mutex> exceptionLock(exceptionMutex);
+
+			if (!exception)
+			{
+				exception = std::current_exception();
+			}
+		}
+
+		if (sourceFinished)
+		{
+			return false;
+		}
+
+		item->sequence = nextSequence++;
+		item->failed = false;
+
+		return true;
+	}
+
+	template<std::default_initializable T>
+	void Pipeline<T>::process(Item* item, size_t stageIndex, bool entered)
+	{
+		if (stageIndex == stages.size())
+		{
+			if (!this->read(item))
+			{
+				// Nothing touches pipeline after last token is returned, run may finish right away
+				activeTokens--;
+
+				return;
+			}
+
+			stageIndex = 0;
+		}
+
+		while (true)
+		{
+			for (; stageIndex < stages.size(); stageIndex++)
+			{
+				Stage& stage = *stages[stageIndex];
+
+				if (!entered && !stage.tryEnter(item))
+				{
+					return;
+				}
+
+				entered = false;
+
+				if (!item->failed)
+				{
+					std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+					try
+					{
+						stage.function(item->value);
+					}
+					catch (...)
+					{
+						item->failed = true;
+
+						this->fail(std::current_exception());
+					}
+
+					stage.busyTime.fetch_add((std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+					stage.processedItems.fetch_add(1, std::memory_order_relaxed);
+				}
+
+				if (Item* next = stage.leave())
+				{
+					threadPool.enqueue(std::make_unique<ItemTask>(*this, next, stageIndex, true));
+				}
+			}
+
+			if (!this->read(item))
+			{
+				activeTokens--;
+
+				return;
+			}
+
+			stageIndex = 0;
+		}
+	}
+
+	template<std::default_initializable T>
+	Pipeline<T>::Pipeline(ThreadPool& threadPool, size_t maxTokens) :
+		threadPool(threadPool),
+		nextSequence(0),
+		sourceFinished(true),
+		activeTokens(0),
+		lastRunTime(0)
+	{
+		items.reserve((std::max)(maxTokens, static_cast<size_t>(1)));
+
+		for (size_t i = 0; i < items.capacity(); i++)
+		{
+			items.emplace_back(std::make_unique<Item>());
+		}
+	}
+
+	template<std::default_initializable T>
+	void Pipeline<T>::addSerialStage(const std::function<void(T&)>& function)
+	{
+		stages.emplace_back(std::make_unique<Stage>(std::function<void(T&)>(function), true, 1));
+	}
+
+	template<std::default_initializable T>
+	void Pipeline<T>::addParallelStage(const std::function<void(T&)>& function, size_t maxConcurrency)
+	{
+		stages.emplace_back(std::make_unique<Stage>(std::function<void(T&)>(function), false, maxConcurrency));
+	}
+
+	template<std::default_initializable T>
+	void Pipeline<T>::run(const std::function<bool(T&)>& source)
+	{
+		using namespace std::chrono_literals;
+
+		this->source = source;
+		nextSequence = 0;
+		sourceFinished = false;
+		exception = nullptr;
+
+		for (std::unique_ptr<Stage>& stage : stages)
+		{
+			stage->nextSequence = 0;
+			stage->lastRunItems = stage->processedItems;
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		activeTokens = items.size();
+
+		for (std::unique_ptr<Item>& item : items)
+		{
+			// Every token starts with reading its first item
+			threadPool.enqueue(std::make_unique<ItemTask>(*this, item.get(), stages.size(), false));
+		}
+
+		while (activeTokens)
+		{
+			threadPool.tryExecuteTask(100us);
+		}
+
+		lastRunTime = std::chrono::steady_clock::now() - start;
+
+		for (std::unique_ptr<Stage>& stage : stages)
+		{
+			stage->lastRunItems = stage->processedItems - stage->lastRunItems;
+		}
+
+		this->source = nullptr;
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	template<std::default_initializable T>
+	PipelineStageStatistics Pipeline<T>::getStageStatistics(size_t stageIndex) const
+	{
+		const Stage& stage = *stages.at(stageIndex);
+		double seconds = std::chrono::duration<double>(lastRunTime).count();
+
+		return
+		{
+			stage.processedItems,
+			std::chrono::nanoseconds(stage.busyTime),
+			seconds > 0.0 ? stage.lastRunItems / seconds : 0.0
+		};
+	}
+
+	template<std::default_initializable T>
+	size_t Pipeline<T>::getStagesCount() const
+	{
+		return stages.size();
+	}
+
+	template<std::default_initializable T>
+	size_t Pipeline<T>::getMaxTokens() const
+	{
+		return items.size();
+	}
+}
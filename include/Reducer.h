@@ -0,0 +1,136 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <algorithm>
+
+namespace threading
+{
+	/**
+	 * @brief Combines values added from many threads without shared hot spot
+	 * @details Every thread adds into its own slot. Slots are combined only on read
+	 * @tparam T Value type
+	 * @tparam OperationT Associative and commutative operation, combine order is unspecified
+	 */
+	template<typename T, typename OperationT = std::plus<T>> requires std::invocable<const OperationT&, const T&, const T&>
+	class Reducer final
+	{
+	private:
+		struct alignas(64) Slot
+		{
+			std::mutex mutex;
+			T value;
+		};
+
+	private:
+		std::unique_ptr<Slot[]> slots;
+		size_t slotsCount;
+		T identity;
+		OperationT operation;
+
+	private:
+		/// @brief Threads get consecutive indices, so up to slotsCount threads never share slot
+		static size_t threadIndex();
+
+	public:
+		/**
+		 * @brief Construct Reducer
+		 * @param identity Initial value of every slot
+		 * @param operation Operation that combines values
+		 * @param slotsCount Number of partial values
+		 */
+		Reducer(const T& identity = T(), const OperationT& operation = OperationT(), size_t slotsCount = std::thread::hardware_concurrency() * 2);
+
+		Reducer(const Reducer&) = delete;
+
+		Reducer& operator =(const Reducer&) = delete;
+
+		/**
+		 * @brief Combine value into slot of calling thread
+		 * @param value Added value
+		 */
+		void add(const T& value);
+
+		/**
+		 * @brief Combine all slots
+		 * @return Result of operation over all added values
+		 */
+		T get() const;
+
+		/**
+		 * @brief Set all slots to identity
+		 */
+		void reset();
+
+		/**
+		 * @brief Getter for slotsCount
+		 * @return
+		 */
+		size_t getSlotsCount() const;
+
+		~Reducer() = default;
+	};
+
+	template<typename T, typename OperationT> requires std::invocable<const OperationT&, const T&, const T&>
+	size_t Reducer<T, OperationT>::threadIndex()
+	{
+		static std::atomic_size_t threadsCount = 0;
+		static thread_local size_t index = threadsCount++;
+
+		return index;
+	}
+
+	template<typename T, typename OperationT> requires std::invocable<const OperationT&, const T&, const T&>
+	Reducer<T, OperationT>::Reducer(const T& identity, const OperationT& operation, size_t slotsCount) :
+		slots(std::make_unique<Slot[]>((std::max)(slotsCount, static_cast<size_t>(1)))),
+		slotsCount((std::max)(slotsCount, static_cast<size_t>(1))),
+		identity(identity),
+		operation(operation)
+	{
+		this->reset();
+	}
+
+	template<typename T, typename OperationT> requires std::invocable<const OperationT&, const T&, const T&>
+	void Reducer<T, OperationT>::add(const T& value)
+	{
+		Slot& slot = slots[Reducer::threadIndex() % slotsCount];
+		std::lock_guard<std::mutex> lock(slot.mutex);
+
+		slot.value = std::invoke(operation, slot.value, value);
+	}
+
+	template<typename T, typename OperationT> requires std::invocable<const OperationT&, const T&, const T&>
+	T Reducer<T, OperationT>::get() const
+	{
+		T result = identity;
+
+		for (size_t i = 0; i < slotsCount; i++)
+		{
+			std::lock_guard<std::mutex> lock(slots[i].mutex);
+
+			result = std::invoke(operation, result, slots[i].value);
+		}
+
+		return result;
+	}
+
+	template<typename T, typename OperationT> requires std::invocable<const OperationT&, const T&, const T&>
+	void Reducer<T, OperationT>::reset()
+	{
+		for (size_t i = 0; i < slotsCount; i++)
+		{
+			std::lock_guard<std::mutex> lock(slots[i].mutex);
+
+			slots[i].value = identity;
+		}
+	}
+
+	template<typename T, typename OperationT> requires std::invocable<const OperationT&, const T&, const T&>
+	size_t Reducer<T, OperationT>::getSlotsCount() const
+	{
+		return slotsCount;
+	}
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "ThreadPool.h"
+#include "Utility/SingleConsumerQueue.h"
+
+namespace threading
+{
+	/**
+	 * @brief Serial executor that runs tasks one by one in adding order on worker threads of ThreadPool
+	 * @details Strand doesn't own thread. Next task is handed to the worker that finished previous one without locks.
+	 * If producer is preempted between publishing and linking its task, drain is rescheduled instead of waiting for it.
+	 * Exception of task goes to its Future and next tasks keep running
+	 */
+	class THREAD_POOL_API Strand final
+	{
+	private:
+		struct State
+		{
+			ThreadPool& threadPool;
+			utility::SingleConsumerQueue<std::unique_ptr<BaseTask>> tasks;
+			std::atomic_size_t pendingTasks;
+			size_t weight;
+
+			State(ThreadPool& threadPool, size_t weight);
+		};
+
+		class DrainTask;
+
+	private:
+		std::shared_ptr<State> state;
+
+	private:
+		static void drain(const std::shared_ptr<State>& state);
+
+	private:
+		void enqueue(std::unique_ptr<BaseTask>&& task);
+
+		std::unique_ptr<Future> addTask(std::unique_ptr<BaseTask>&& task);
+
+	public:
+		/**
+		 * @brief Construct Strand
+		 * @param threadPool ThreadPool that executes tasks of this strand
+		 * @param weight How many tasks strand executes in a row before giving worker thread to other tasks
+		 */
+		Strand(ThreadPool& threadPool, size_t weight = 64);
+
+		Strand(const Strand&) = delete;
+
+		Strand& operator =(const Strand&) = delete;
+
+		/// @brief Add new task to strand
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to strand
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, std::function<void()>&& callback);
+
+		/// @brief Add new task to strand
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to strand
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, std::function<void()>&& callback);
+
+		/**
+		 * @brief Add new task to strand
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to strand
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to strand
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Args&&... args);
+
+		/**
+		 * @brief Get tasks of this strand that are queued or running
+		 * @return
+		 */
+		size_t getPendingTasks() const;
+
+		/**
+		 * @brief Getter for weight
+		 * @return
+		 */
+		size_t getWeight() const;
+
+		/**
+		 * @brief Queued tasks keep running after Strand is destroyed
+		 */
+		~Strand() = default;
+	};
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> Strand::addTask(F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...)
+		);
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> Strand::addTask(F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...)
+		);
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> Strand::addTask(Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<TaskT>(std::forward<Args>(args)...)
+		);
+	}
+}
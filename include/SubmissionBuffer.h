@@ -0,0 +1,134 @@
+#pragma once
+
+#include "ThreadPool.h"
+
+namespace threading
+{
+	/**
+	 * @brief Buffer of one producer thread that adds tasks to ThreadPool in batches
+	 * @details Batch is added with one queue lock and one semaphore release when buffer is full, on flush or when its oldest task waited linger time.
+	 * Buffered tasks are not visible to ThreadPool until they are flushed.
+	 * Buffer is an object owned by producer thread rather than thread_local storage, so linger flusher can flush it and its tasks are not lost when thread exits.
+	 * Its mutex is contended only by that flusher. Flusher thread starts with the first buffer that has linger and stops when the last such buffer is destroyed
+	 */
+	class THREAD_POOL_API SubmissionBuffer final
+	{
+	private:
+		class LingerFlusher;
+
+	private:
+		ThreadPool& threadPool;
+		std::vector<std::unique_ptr<BaseTask>> tasks;
+		mutable std::mutex tasksMutex;
+		std::chrono::steady_clock::time_point oldestTaskTime;
+		size_t capacity;
+		std::chrono::microseconds linger;
+		std::shared_ptr<LingerFlusher> flusher;
+
+	private:
+		/// @brief Flush with locked tasksMutex
+		void flushTasks();
+
+		void enqueue(std::unique_ptr<BaseTask>&& task);
+
+		std::unique_ptr<Future> addTask(std::unique_ptr<BaseTask>&& task);
+
+	public:
+		/**
+		 * @brief Construct SubmissionBuffer
+		 * @param threadPool ThreadPool that executes flushed tasks. Must outlive SubmissionBuffer
+		 * @param capacity Number of buffered tasks that triggers flush
+		 * @param linger Max time task stays in buffer(0 means tasks are flushed only when buffer is full or on flush)
+		 */
+		SubmissionBuffer(ThreadPool& threadPool, size_t capacity = 64, std::chrono::microseconds linger = std::chrono::microseconds(100));
+
+		SubmissionBuffer(const SubmissionBuffer&) = delete;
+
+		SubmissionBuffer& operator =(const SubmissionBuffer&) = delete;
+
+		/// @brief Add new task to buffer
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to buffer
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, std::function<void()>&& callback);
+
+		/// @brief Add new task to buffer
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to buffer
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, std::function<void()>&& callback);
+
+		/**
+		 * @brief Add new task to buffer
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to buffer
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to buffer
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Args&&... args);
+
+		/**
+		 * @brief Add all buffered tasks to ThreadPool
+		 */
+		void flush();
+
+		/**
+		 * @brief Get number of buffered tasks
+		 * @return
+		 */
+		size_t size() const;
+
+		/**
+		 * @brief Getter for capacity
+		 * @return
+		 */
+		size_t getCapacity() const;
+
+		/**
+		 * @brief Getter for linger
+		 * @return
+		 */
+		std::chrono::microseconds getLinger() const;
+
+		/**
+		 * @brief Flushes buffered tasks
+		 */
+		~SubmissionBuffer();
+	};
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> SubmissionBuffer::addTask(F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...)
+		);
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> SubmissionBuffer::addTask(F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...)
+		);
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> SubmissionBuffer::addTask(Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<TaskT>(std::forward<Args>(args)...)
+		);
+	}
+}
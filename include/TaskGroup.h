@@ -0,0 +1,276 @@
+#pragma once
+
+#include <exception>
+
+#include "Partition.h"
+
+namespace threading
+{
+	/**
+	 * @brief Group of tasks that can be waited together and optionally limited in concurrency
+	 */
+	class THREAD_POOL_API TaskGroup final
+	{
+	private:
+		struct State
+		{
+			std::atomic_size_t pendingTasks;
+			std::exception_ptr exception;
+			std::mutex exceptionMutex;
+
+			State();
+
+			/// @brief Remember first exception of group tasks
+			void fail(std::exception_ptr exception);
+
+			void finish();
+		};
+
+		/// @brief Task leaves group even if it throws
+		struct FinishGuard
+		{
+			State& state;
+
+			~FinishGuard();
+		};
+
+		class GroupTask;
+
+		template<typename F>
+		class SpawnTask;
+
+	private:
+		ThreadPool& threadPool;
+		std::unique_ptr<Partition> partition;
+		std::shared_ptr<State> state;
+
+	private:
+		void enqueue(std::unique_ptr<BaseTask>&& task);
+
+		std::unique_ptr<Future> addTask(std::unique_ptr<BaseTask>&& task);
+
+		/// @brief Execute queued tasks of ThreadPool in calling thread until all added tasks are finished
+		void help();
+
+		/// @brief Rethrow first exception of group tasks once
+		void rethrow();
+
+	public:
+		/**
+		 * @brief Construct TaskGroup
+		 * @param threadPool ThreadPool that executes tasks of this group
+		 * @param maxConcurrency Max number of tasks of this group that run at the same time(0 means no limit). Tasks over the limit stay queued and don't occupy worker threads
+		 */
+		TaskGroup(ThreadPool& threadPool, size_t maxConcurrency = 0);
+
+		TaskGroup(const TaskGroup&) = delete;
+
+		TaskGroup& operator =(const TaskGroup&) = delete;
+
+		/// @brief Add new task to group
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to group
+		std::unique_ptr<Future> addTask(const std::function<void()>& task, std::function<void()>&& callback);
+
+		/// @brief Add new task to group
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to group
+		std::unique_ptr<Future> addTask(std::function<void()>&& task, std::function<void()>&& callback);
+
+		/**
+		 * @brief Add new task to group
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues. Move only arguments are supported
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to group
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to group
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Args&&... args);
+
+		/**
+		 * @brief Add task to group without creating Future
+		 * @param task Any callable object
+		 * @param args Arguments that are moved into task
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		void spawn(F&& task, Args&&... args);
+
+		/**
+		 * @brief Add task to group without creating Future
+		 * @param result Where result of task is written. Must stay valid until join or wait
+		 * @param task Any callable object
+		 * @param args Arguments that are moved into task
+		 */
+		template<typename R, typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		void spawn(R* result, F&& task, Args&&... args);
+
+		/**
+		 * @brief Wait until all added tasks are finished
+		 * @exception Rethrows first exception of tasks. Future of task added with addTask also gets its exception
+		 */
+		void wait();
+
+		/**
+		 * @brief Wait until all added tasks are finished executing queued tasks of ThreadPool in calling thread meanwhile
+		 * @details Allows nested groups in tasks of ThreadPool without blocking worker threads
+		 * @exception Rethrows first exception of tasks. Future of task added with addTask also gets its exception
+		 */
+		void join();
+
+		/**
+		 * @brief Get number of added tasks that are not finished yet
+		 * @return
+		 */
+		size_t getPendingTasks() const;
+
+		/**
+		 * @brief Getter for maxConcurrency
+		 * @return 0 if group is not limited
+		 */
+		size_t getMaxConcurrency() const;
+
+		/**
+		 * @brief Joins all added tasks. Exceptions of tasks are not rethrown
+		 */
+		~TaskGroup();
+	};
+
+	template<typename F>
+	class TaskGroup::SpawnTask : public BaseTask
+	{
+	private:
+		F function;
+		std::shared_ptr<State> state;
+
+	protected:
+		void executeImplementation() override;
+
+		std::unique_ptr<Promise> createTaskPromise() const override;
+
+	public:
+		SpawnTask(F&& function, const std::shared_ptr<State>& state);
+
+		void execute() override;
+
+		std::string_view getName() const override;
+
+		~SpawnTask() = default;
+	};
+
+	inline void TaskGroup::State::finish()
+	{
+		if (pendingTasks.fetch_sub(1) == 1)
+		{
+			pendingTasks.notify_all();
+		}
+	}
+
+	inline TaskGroup::FinishGuard::~FinishGuard()
+	{
+		state.finish();
+	}
+
+	template<typename F>
+	void TaskGroup::SpawnTask<F>::executeImplementation()
+	{
+		function();
+	}
+
+	template<typename F>
+	std::unique_ptr<Promise> TaskGroup::SpawnTask<F>::createTaskPromise() const
+	{
+		return nullptr;
+	}
+
+	template<typename F>
+	TaskGroup::SpawnTask<F>::SpawnTask(F&& function, const std::shared_ptr<State>& state) :
+		function(std::move(function)),
+		state(state)
+	{
+
+	}
+
+	template<typename F>
+	void TaskGroup::SpawnTask<F>::execute()
+	{
+		FinishGuard guard{ *state };
+
+		try
+		{
+			this->executeImplementation();
+		}
+		catch (...)
+		{
+			state->fail(std::current_exception());
+		}
+	}
+
+	template<typename F>
+	std::string_view TaskGroup::SpawnTask<F>::getName() const
+	{
+		return "TaskGroup";
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	void TaskGroup::spawn(F&& task, Args&&... args)
+	{
+		auto function = [task = std::forward<F>(task), ...args = std::forward<Args>(args)]() mutable
+			{
+				std::invoke(std::move(task), std::move(args)...);
+			};
+
+		state->pendingTasks++;
+
+		this->enqueue(std::make_unique<SpawnTask<decltype(function)>>(std::move(function), state));
+	}
+
+	template<typename R, typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	void TaskGroup::spawn(R* result, F&& task, Args&&... args)
+	{
+		auto function = [result, task = std::forward<F>(task), ...args = std::forward<Args>(args)]() mutable
+			{
+				*result = std::invoke(std::move(task), std::move(args)...);
+			};
+
+		state->pendingTasks++;
+
+		this->enqueue(std::make_unique<SpawnTask<decltype(function)>>(std::move(function), state));
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> TaskGroup::addTask(F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...)
+		);
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> TaskGroup::addTask(F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...)
+		);
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> TaskGroup::addTask(Args&&... args)
+	{
+		return this->addTask
+		(
+			std::make_unique<TaskT>(std::forward<Args>(args)...)
+		);
+	}
+}
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <string_view>
+
 #include "Utility/Promise.h"
 
 namespace threading
@@ -11,6 +14,9 @@ namespace threading
 	{
 	protected:
 		std::unique_ptr<Promise> taskPromise;
+		std::chrono::steady_clock::time_point enqueueTime;
+		std::chrono::steady_clock::time_point deadline = (std::chrono::steady_clock::time_point::max)();
+		std::string_view label;
 
 	protected:
 		virtual void executeImplementation() = 0;
@@ -30,6 +36,12 @@ namespace threading
 
 		virtual float getProgress() const;
 
+		/**
+		 * @brief Name of task in traces
+		 * @return Must stay valid while task exists
+		 */
+		virtual std::string_view getName() const;
+
 		virtual ~BaseTask() = default;
 
 		friend class ThreadPool;
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "BaseTask.h"
+
+#include <functional>
+#include <tuple>
+
+#include "Utility/FunctionWrapperPromise.h"
+
+namespace threading
+{
+	/**
+	 * @brief Move only task that stores callable and its arguments without type erasure
+	 * @tparam F Any callable object, including member function pointers
+	 * @tparam Args Stored arguments. Moved into callable when task is executed
+	 */
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	class CallableTask : public BaseTask
+	{
+	public:
+		using ResultT = std::invoke_result_t<F, Args...>;
+
+	protected:
+		F function;
+		std::tuple<Args...> arguments;
+		std::function<void()> callbackFunction;
+
+	protected:
+		void executeImplementation() override;
+
+		std::unique_ptr<Promise> createTaskPromise() const override;
+
+	public:
+		template<typename FunctionT, typename... ArgumentsT>
+		CallableTask(FunctionT&& function, const std::function<void()>& callbackFunction, ArgumentsT&&... arguments);
+
+		template<typename FunctionT, typename... ArgumentsT>
+		CallableTask(FunctionT&& function, std::function<void()>&& callbackFunction, ArgumentsT&&... arguments);
+
+		CallableTask(const CallableTask&) = delete;
+
+		CallableTask& operator =(const CallableTask&) = delete;
+
+		void execute() override;
+
+		std::string_view getName() const override;
+
+		~CallableTask() = default;
+	};
+
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	void CallableTask<F, Args...>::executeImplementation()
+	{
+
+	}
+
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	std::unique_ptr<Promise> CallableTask<F, Args...>::createTaskPromise() const
+	{
+		return std::make_unique<FunctionWrapperPromise<ResultT>>();
+	}
+
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	template<typename FunctionT, typename... ArgumentsT>
+	CallableTask<F, Args...>::CallableTask(FunctionT&& function, const std::function<void()>& callbackFunction, ArgumentsT&&... arguments) :
+		function(std::forward<FunctionT>(function)),
+		arguments(std::forward<ArgumentsT>(arguments)...),
+		callbackFunction(callbackFunction)
+	{
+
+	}
+
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	template<typename FunctionT, typename... ArgumentsT>
+	CallableTask<F, Args...>::CallableTask(FunctionT&& function, std::function<void()>&& callbackFunction, ArgumentsT&&... arguments) :
+		function(std::forward<FunctionT>(function)),
+		arguments(std::forward<ArgumentsT>(arguments)...),
+		callbackFunction(std::move(callbackFunction))
+	{
+
+	}
+
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	void CallableTask<F, Args...>::execute()
+	{
+		if constexpr (std::is_same_v<ResultT, void>)
+		{
+			std::apply(std::move(function), std::move(arguments));
+
+			if (callbackFunction)
+			{
+				callbackFunction();
+			}
+
+			dynamic_cast<FunctionWrapperPromise<ResultT>&>(*taskPromise).getPromise().set_value();
+		}
+		else
+		{
+			ResultT result = std::apply(std::move(function), std::move(arguments));
+
+			if (callbackFunction)
+			{
+				callbackFunction();
+			}
+
+			dynamic_cast<FunctionWrapperPromise<ResultT>&>(*taskPromise).getPromise().set_value(std::forward<ResultT>(result));
+		}
+	}
+
+	template<typename F, typename... Args> requires std::invocable<F, Args...>
+	std::string_view CallableTask<F, Args...>::getName() const
+	{
+		return label.empty() ? "CallableTask" : label;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "BaseTask.h"
+
+#include <functional>
+#include <tuple>
+
+namespace threading
+{
+	/**
+	 * @brief Task without Promise and Future. Result is moved into callback
+	 * @tparam F Any callable object, including member function pointers
+	 * @tparam CallbackT Called with result of F as rvalue, or without arguments if F returns void. std::nullptr_t means no callback
+	 * @tparam Args Stored arguments. Moved into callable when task is executed
+	 */
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<F, Args...>
+	class DetachedTask : public BaseTask
+	{
+	public:
+		using ResultT = std::invoke_result_t<F, Args...>;
+
+	protected:
+		F function;
+		CallbackT callbackFunction;
+		std::tuple<Args...> arguments;
+
+	protected:
+		void executeImplementation() override;
+
+		std::unique_ptr<Promise> createTaskPromise() const override;
+
+	public:
+		template<typename FunctionT, typename CallbackFunctionT, typename... ArgumentsT>
+		DetachedTask(FunctionT&& function, CallbackFunctionT&& callbackFunction, ArgumentsT&&... arguments);
+
+		DetachedTask(const DetachedTask&) = delete;
+
+		DetachedTask& operator =(const DetachedTask&) = delete;
+
+		void execute() override;
+
+		std::string_view getName() const override;
+
+		~DetachedTask() = default;
+	};
+
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<F, Args...>
+	void DetachedTask<F, CallbackT, Args...>::executeImplementation()
+	{
+		if constexpr (std::is_same_v<CallbackT, std::nullptr_t>)
+		{
+			std::apply(std::move(function), std::move(arguments));
+		}
+		else if constexpr (std::is_same_v<ResultT, void>)
+		{
+			std::apply(std::move(function), std::move(arguments));
+
+			std::invoke(callbackFunction);
+		}
+		else
+		{
+			std::invoke(callbackFunction, std::apply(std::move(function), std::move(arguments)));
+		}
+	}
+
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<F, Args...>
+	std::unique_ptr<Promise> DetachedTask<F, CallbackT, Args...>::createTaskPromise() const
+	{
+		return nullptr;
+	}
+
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<F, Args...>
+	template<typename FunctionT, typename CallbackFunctionT, typename... ArgumentsT>
+	DetachedTask<F, CallbackT, Args...>::DetachedTask(FunctionT&& function, CallbackFunctionT&& callbackFunction, ArgumentsT&&... arguments) :
+		function(std::forward<FunctionT>(function)),
+		callbackFunction(std::forward<CallbackFunctionT>(callbackFunction)),
+		arguments(std::forward<ArgumentsT>(arguments)...)
+	{
+
+	}
+
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<F, Args...>
+	void DetachedTask<F, CallbackT, Args...>::execute()
+	{
+		this->executeImplementation();
+	}
+
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<F, Args...>
+	std::string_view DetachedTask<F, CallbackT, Args...>::getName() const
+	{
+		return label.empty() ? "DetachedTask" : label;
+	}
+}
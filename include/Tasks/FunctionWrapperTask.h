@@ -31,6 +31,8 @@ namespace threading
 
 		virtual void execute() override;
 
+		virtual std::string_view getName() const override;
+
 		virtual ~FunctionWrapperTask() = default;
 	};
 
@@ -104,4 +106,10 @@ namespace threading
 			dynamic_cast<FunctionWrapperPromise<R>&>(*taskPromise).getPromise().set_value(result);
 		}
 	}
+
+	template<typename R, typename... ArgsT>
+	std::string_view FunctionWrapperTask<R, ArgsT...>::getName() const
+	{
+		return label.empty() ? "FunctionWrapperTask" : label;
+	}
 }
@@ -3,15 +3,60 @@
 #include <thread>
 #include <semaphore>
 #include <mutex>
+#include <condition_variable>
 #include <vector>
 #include <functional>
 #include <concepts>
+#include <chrono>
+#include <filesystem>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
 
 #include "Tasks/FunctionWrapperTask.h"
+#include "Tasks/CallableTask.h"
+#include "Tasks/DetachedTask.h"
 #include "Utility/ConcurrentQueue.h"
+#include "Utility/ConcurrentPriorityQueue.h"
+#include "Utility/SingleProducerQueue.h"
+#include "Utility/TraceBuffer.h"
 
 namespace threading
 {
+	/// @brief Tasks with same affinity key prefer same worker thread
+	struct Affinity
+	{
+		size_t key;
+
+		explicit Affinity(size_t key);
+	};
+
+	/// @brief Time by which task must be finished. Task with nearest deadline is executed first
+	struct Deadline
+	{
+		std::chrono::steady_clock::time_point time;
+
+		explicit Deadline(std::chrono::steady_clock::time_point time);
+
+		/// @param timeout Time from now
+		explicit Deadline(std::chrono::steady_clock::duration timeout);
+	};
+
+	/// @brief Name of task in traces. Referenced string must outlive task, e.g. string literal
+	struct Label
+	{
+		std::string_view name;
+
+		explicit Label(std::string_view name);
+	};
+
+	/// @brief Thrown from Future of task that was cancelled because its deadline expired
+	class THREAD_POOL_API DeadlineExceeded : public std::runtime_error
+	{
+	public:
+		DeadlineExceeded();
+	};
+
 	/// @brief ThreadPool
 	class THREAD_POOL_API ThreadPool final
 	{
@@ -22,24 +67,132 @@ namespace threading
 			waiting
 		};
 
+		/// @brief What worker does with task whose deadline expired before it started
+		enum class ExpiredTaskPolicy
+		{
+			execute,
+			cancel
+		};
+
+		/// @brief How tasks without affinity and deadline get to worker threads
+		enum class SubmissionMode
+		{
+			/// @brief Any thread adds tasks to shared queue under mutex
+			multipleProducers,
+			/// @brief Producer thread adds tasks to lock-free ring and wakes worker only if some worker waits. Tasks of other threads and tasks over ring capacity go to shared queue
+			singleProducer
+		};
+
+		/// @brief Number of tasks that fit in lock-free ring of SubmissionMode::singleProducer
+		static constexpr size_t submissionRingCapacity = 1 << 16;
+
+		class BlockingRegion;
+
+	private:
+		using TaskQueue = utility::ConcurrentQueue<std::unique_ptr<BaseTask>>;
+
 	private:
+		/// @brief Tasks of one worker. Other workers steal them only if owner is busy or mailbox is long
+		struct Mailbox
+		{
+			TaskQueue tasks;
+			/// @brief Owner executes task
+			std::atomic_bool busy;
+
+			Mailbox(bool shardedCounters);
+		};
+
+		using Mailboxes = std::vector<std::shared_ptr<Mailbox>>;
+
+		struct LaterDeadline
+		{
+			bool operator ()(const std::unique_ptr<BaseTask>& left, const std::unique_ptr<BaseTask>& right) const;
+		};
+
+		/// @brief Tasks with deadlines ordered earliest first
+		struct DeadlineTasks
+		{
+			utility::ConcurrentPriorityQueue<std::unique_ptr<BaseTask>, LaterDeadline> tasks;
+			std::atomic_size_t missedDeadlines = 0;
+			std::atomic_size_t expiredTasks = 0;
+		};
+
+		/// @brief Snapshot of worker mailboxes. Replaced as a whole when workers change
+		struct MailboxList
+		{
+			mutable std::shared_mutex mutex;
+			/// @brief Empty until workers are published, so workers started before that don't read null list
+			std::shared_ptr<const Mailboxes> mailboxes = std::make_shared<const Mailboxes>();
+			std::atomic_size_t workersCount = 0;
+
+			std::shared_ptr<const Mailboxes> load() const;
+		};
+
+		/// @brief Lock-free ring of SubmissionMode::singleProducer
+		/// @details Ring tasks don't carry semaphore tokens. Workers drain ring before they wait for token
+		struct SubmissionRing
+		{
+			utility::SingleProducerQueue<BaseTask*> tasks;
+			std::atomic<std::thread::id> producer;
+			/// @brief Workers that checked ring and wait for token
+			std::atomic_size_t sleepers;
+			/// @brief Token that wakes worker for ring tasks is released and not taken yet
+			std::atomic_bool waking;
+
+			SubmissionRing(std::thread::id producer);
+
+			bool isProducer() const;
+
+			/// @brief Release token if some worker waits and no other token wakes it for ring
+			void wake(std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>& hasTask);
+
+			~SubmissionRing();
+		};
+
+		/// @brief Settings that can be changed while workers are running
+		struct Settings
+		{
+			std::atomic_size_t batchSize = 1;
+			std::atomic<ExpiredTaskPolicy> expiredTaskPolicy = ExpiredTaskPolicy::execute;
+			std::atomic_size_t maxCompensatingThreads = std::thread::hardware_concurrency();
+		};
+
+		struct Retirement
+		{
+			std::atomic_size_t requests = 0;
+			std::atomic_size_t retired = 0;
+
+			/// @brief Take one retire request
+			/// @return Returns true if calling worker must retire
+			bool tryRetire();
+		};
+
+		struct Compensators;
+
 		struct Worker
 		{
 		public:
 			std::shared_ptr<BaseTask> task;
 			std::atomic<ThreadState> state;
 			std::atomic_bool running;
+			std::atomic_bool retired;
 			bool deleteSelf;
 			std::thread::id id;
+			std::unique_ptr<utility::TraceBuffer> traceBuffer;
+			std::shared_ptr<Mailbox> mailbox;
+			bool compensating;
 
 		private:
-			void workerThread(std::shared_ptr<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>> tasks, std::shared_ptr<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>> hasTask);
+			void execute(std::unique_ptr<BaseTask>&& newTask, DeadlineTasks& deadlineTasks, ExpiredTaskPolicy expiredTaskPolicy);
+
+			void workerThread(std::shared_ptr<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>> tasks, std::shared_ptr<SubmissionRing> ring, std::shared_ptr<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>> hasTask, std::shared_ptr<DeadlineTasks> deadlineTasks, std::shared_ptr<MailboxList> mailboxes, std::shared_ptr<Retirement> retirement, std::shared_ptr<Settings> settings, std::shared_ptr<Compensators> compensators);
 
 		private:
 			std::thread thread;
 
 		public:
-			Worker(ThreadPool* threadPool);
+			/// @param compensating Temporary thread of BlockingRegion. It has no mailbox and deletes itself after stop
+			Worker(ThreadPool* threadPool, bool compensating = false);
 
 			void join();
 
@@ -48,12 +201,82 @@ namespace threading
 			~Worker();
 		};
 
+		/// @brief Threads of BlockingRegion. Stopped thread stays in list until it takes token, so next region can reuse it
+		struct Compensators
+		{
+			std::mutex mutex;
+			std::condition_variable threadLeft;
+			std::vector<Worker*> threads;
+			std::atomic_size_t active = 0;
+			/// @brief Regions don't get threads after thread pool stopped them
+			bool stopped = false;
+
+			/// @brief Remove stopped thread from list
+			/// @return Returns false if region reused thread, then thread keeps working
+			bool leave(Worker& worker);
+		};
+
 	private:
 		std::shared_ptr<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>> tasks;
 		std::shared_ptr<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>> hasTask;
+		std::shared_ptr<SubmissionRing> ring;
+		std::shared_ptr<DeadlineTasks> deadlineTasks;
+		std::shared_ptr<MailboxList> mailboxes;
+		std::shared_ptr<Retirement> retirement;
+		std::shared_ptr<Settings> settings;
 		std::vector<Worker*> workers;
+		/// @brief Size of workers that can be read from any thread while workers are changed
+		std::atomic_size_t threadsCount;
+		std::shared_ptr<Compensators> compensators;
+		bool shardedCounters;
+		SubmissionMode submissionMode;
+		/// @brief Producer of ring, kept for rings created on reinit
+		std::thread::id producer;
 
 	private:
+		static std::unique_ptr<Future> prepareTask(BaseTask& task);
+
+		static void markEnqueued(BaseTask& task);
+
+		/// @brief Finish Future of task with exception without executing task
+		static void cancelTask(BaseTask& task, std::exception_ptr exception);
+
+		static void executeTask(BaseTask& task);
+
+		/// @brief Execute task and count missed deadline. Expired task can be cancelled instead
+		static void executeTask(BaseTask& task, DeadlineTasks& deadlineTasks, ExpiredTaskPolicy expiredTaskPolicy);
+
+		/// @brief Pop task that carries token: from own mailbox, then task with earliest deadline, then from shared queue, then steal from mailboxes of other workers
+		/// @param batchSize Max tasks taken from shared queue at once. Extra tasks go to mailbox
+		static std::optional<std::unique_ptr<BaseTask>> takeTask(TaskQueue& tasks, DeadlineTasks& deadlineTasks, const MailboxList& mailboxes, Mailbox* mailbox, size_t batchSize = 1);
+
+	private:
+		void enqueue(std::unique_ptr<BaseTask>&& task);
+
+		void enqueue(std::unique_ptr<BaseTask>&& task, Affinity affinity);
+
+		void enqueue(std::unique_ptr<BaseTask>&& task, Deadline deadline);
+
+		/// @brief Add tasks to shared queue with one lock and one semaphore release
+		void enqueue(std::vector<std::unique_ptr<BaseTask>>&& tasks);
+
+		/// @brief Make mailboxes of current workers visible for stealing and affinity tasks
+		void publishMailboxes();
+
+		/// @brief Stop all workers after their current task without waiting them
+		void detachWorkers();
+
+		/// @brief Stop compensating threads after their current task without waiting them. Regions entered after that get no thread
+		void stopCompensators();
+
+		/// @brief Retire workers after their current task, queued tasks stay in thread pool
+		void retireWorkers(size_t count);
+
+		/// @brief Execute one queued task in calling thread
+		/// @param timeout How long to wait for task
+		/// @return Returns true if task was executed
+		bool tryExecuteTask(std::chrono::microseconds timeout = std::chrono::microseconds::zero());
+
 		std::unique_ptr<Future> addTask(std::unique_ptr<BaseTask>&& task);
 
 	public:
@@ -65,7 +288,9 @@ namespace threading
 	public:
 		/// @brief Construct ThreadPool
 		/// @param threadCount Number of threads in ThreadPool(default is max threads for current hardware)
-		ThreadPool(size_t threadsCount = std::thread::hardware_concurrency());
+		/// @param shardedCounters Count queue sizes in per thread counters that are changed outside of queue locks, so producers and workers don't share one counter. getQueuedTasks becomes approximate unless exact is requested
+		/// @param submissionMode singleProducer makes adding tasks from one dedicated thread lock-free
+		ThreadPool(size_t threadsCount = std::thread::hardware_concurrency(), bool shardedCounters = false, SubmissionMode submissionMode = SubmissionMode::multipleProducers);
 
 		/// @brief Add new task to thread pool
 		std::unique_ptr<Future> addTask(const std::function<void()>& task, const std::function<void()>& callback = nullptr);
@@ -79,21 +304,17 @@ namespace threading
 		/// @brief Add new task to thread pool
 		std::unique_ptr<Future> addTask(std::function<void()>&& task, std::function<void()>&& callback);
 
-		/// @brief Add new task to thread pool
-		template<typename R, typename... ArgsT, typename... Args>
-		std::unique_ptr<Future> addTask(const std::function<R(ArgsT...)>& task, const std::function<void()>& callback, Args&&... args);
-
-		/// @brief Add new task to thread pool
-		template<typename R, typename... ArgsT, typename... Args>
-		std::unique_ptr<Future> addTask(R(*task)(ArgsT...), const std::function<void()>& callback, Args&&... args);
-
-		/// @brief Add new task to thread pool
-		template<typename R, typename... ArgsT, typename... Args>
-		std::unique_ptr<Future> addTask(const std::function<R(ArgsT...)>& task, std::function<void()>&& callback, Args&&... args);
+		/**
+		 * @brief Add new task to thread pool
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues. Move only arguments are supported
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, const std::function<void()>& callback, Args&&... args);
 
 		/// @brief Add new task to thread pool
-		template<typename R, typename... ArgsT, typename... Args>
-		std::unique_ptr<Future> addTask(R(*task)(ArgsT...), std::function<void()>&& callback, Args&&... args);
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(F&& task, std::function<void()>&& callback, Args&&... args);
 
 		/**
 		* @brief Create custom new task of type TaskT and add that task to thread pool
@@ -101,18 +322,199 @@ namespace threading
 		template<std::derived_from<BaseTask> TaskT, typename... Args>
 		std::unique_ptr<Future> addTask(Args&&... args);
 
+		/**
+		 * @brief Add new task to thread pool without creating Future. Result of task is moved into callback
+		 * @param callback Called in worker thread with result of task as rvalue
+		 * @param args Arguments that are stored in task without copies if passed as rvalues
+		 */
+		template<typename F, typename CallbackT, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...> && std::invocable<std::decay_t<CallbackT>, std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>&&>
+		void addTask(F&& task, CallbackT&& callback, Args&&... args);
+
+		/**
+		 * @brief Add new task to thread pool without creating Promise and Future
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		void spawn(F&& task, Args&&... args);
+
+		/// @brief Add new task to thread pool. Tasks with same affinity key prefer same worker thread, but idle workers can steal them while that thread is busy
+		std::unique_ptr<Future> addTask(Affinity affinity, const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to thread pool. Tasks with same affinity key prefer same worker thread, but idle workers can steal them while that thread is busy
+		std::unique_ptr<Future> addTask(Affinity affinity, std::function<void()>&& task, std::function<void()>&& callback = nullptr);
+
+		/// @brief Add new task to thread pool. Tasks with same affinity key prefer same worker thread, but idle workers can steal them while that thread is busy
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(Affinity affinity, F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to thread pool. Tasks with same affinity key prefer same worker thread, but idle workers can steal them while that thread is busy
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(Affinity affinity, F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to thread pool. Tasks with same affinity key prefer same worker thread
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Affinity affinity, Args&&... args);
+
+		/// @brief Add new task to thread pool. Tasks with deadline are executed earliest deadline first and before tasks without deadline
+		std::unique_ptr<Future> addTask(Deadline deadline, const std::function<void()>& task, const std::function<void()>& callback = nullptr);
+
+		/// @brief Add new task to thread pool. Tasks with deadline are executed earliest deadline first and before tasks without deadline
+		std::unique_ptr<Future> addTask(Deadline deadline, std::function<void()>&& task, std::function<void()>&& callback = nullptr);
+
+		/// @brief Add new task to thread pool. Tasks with deadline are executed earliest deadline first and before tasks without deadline
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(Deadline deadline, F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/// @brief Add new task to thread pool. Tasks with deadline are executed earliest deadline first and before tasks without deadline
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(Deadline deadline, F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/**
+		* @brief Create custom new task of type TaskT and add that task to thread pool. Tasks with deadline are executed earliest deadline first
+		*/
+		template<std::derived_from<BaseTask> TaskT, typename... Args>
+		std::unique_ptr<Future> addTask(Deadline deadline, Args&&... args);
+
+		/**
+		 * @brief Add new task to thread pool that is shown in traces with given name
+		 * @param task Any callable object, including member function pointers
+		 * @param args Arguments that are stored in task without copies if passed as rvalues
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(Label label, F&& task, const std::function<void()>& callback = nullptr, Args&&... args);
+
+		/// @brief Add new task to thread pool that is shown in traces with given name
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addTask(Label label, F&& task, std::function<void()>&& callback, Args&&... args);
+
+		/// @brief Add new task to thread pool without creating Promise and Future that is shown in traces with given name
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		void spawn(Label label, F&& task, Args&&... args);
+
 		/// @brief Reinitialize thread pool
-		/// @param wait Wait all threads execution
+		/// @param wait Wait all threads execution. Otherwise old threads finish their current task in background and queued tasks are handed off to new threads
 		/// @param threadsCount New thread pool size
 		void reinit(bool wait = true, size_t threadsCount = std::thread::hardware_concurrency());
 
 		/// @brief Change thread pool size
+		/// @details Shrinking retires only extra threads after their current task. Queued tasks and other threads are untouched.
+		/// Shrinking blocks until enough threads finish their current task, so it must not be called from task of this thread pool
 		bool resize(size_t threadsCount);
 
 		/// @brief Stop ThreadPool
 		/// @param wait Wait all threads execution
 		void shutdown(bool wait = true);
 
+		/**
+		 * @brief Execute queued tasks in calling thread without waiting for new ones
+		 * @param maxTasks Max number of executed tasks
+		 * @return Number of executed tasks
+		 */
+		size_t runPending(size_t maxTasks = (std::numeric_limits<size_t>::max)());
+
+		/**
+		 * @brief Execute queued tasks in calling thread until predicate returns true
+		 * @param predicate Checked before each task and at least every 100 microseconds while queue is empty
+		 * @return Number of executed tasks
+		 */
+		template<std::predicate PredicateT>
+		size_t runUntil(PredicateT&& predicate);
+
+		/**
+		 * @brief Execute queued tasks in calling thread during duration
+		 * @details Task started before deadline runs to completion even if it finishes after deadline
+		 * @return Number of executed tasks
+		 */
+		size_t runFor(std::chrono::microseconds duration);
+
+		/**
+		 * @brief Set how many tasks worker takes from shared queue at once
+		 * @param batchSize Max tasks per queue access(1 disables batching)
+		 * @details Worker takes at most its fair share of queued tasks. Extra tasks are moved to its mailbox where idle workers can steal them while it is busy
+		 */
+		void setBatchSize(size_t batchSize);
+
+		/**
+		 * @brief Getter for batchSize
+		 * @return
+		 */
+		size_t getBatchSize() const;
+
+		/**
+		 * @brief Set what workers do with tasks whose deadline expired before they started
+		 * @param expiredTaskPolicy cancel finishes Future of such task with DeadlineExceeded without executing it
+		 */
+		void setExpiredTaskPolicy(ExpiredTaskPolicy expiredTaskPolicy);
+
+		/**
+		 * @brief Getter for expiredTaskPolicy
+		 * @return
+		 */
+		ExpiredTaskPolicy getExpiredTaskPolicy() const;
+
+		/**
+		 * @brief Get number of tasks with deadline that finished or were cancelled after their deadline
+		 * @return
+		 */
+		size_t getMissedDeadlines() const;
+
+		/**
+		 * @brief Get number of tasks that were cancelled because their deadline expired
+		 * @return
+		 */
+		size_t getExpiredTasks() const;
+
+		/**
+		 * @brief Mark following code of current task as blocking until returned object is destroyed
+		 * @details Outside of worker threads of this ThreadPool nothing happens
+		 */
+		BlockingRegion blockingRegion();
+
+		/**
+		 * @brief Add task that blocks most of its time. Task runs in BlockingRegion
+		 */
+		template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+		std::unique_ptr<Future> addBlockingTask(F&& task, const std::function<void()>& callback, Args&&... args);
+
+		/**
+		 * @brief Getter for submissionMode
+		 * @return
+		 */
+		SubmissionMode getSubmissionMode() const;
+
+		/**
+		 * @brief Make calling thread producer of lock-free ring of SubmissionMode::singleProducer. Thread that constructs ThreadPool is producer by default
+		 * @details Previous producer must not add tasks concurrently
+		 */
+		void bindProducer();
+
+		/**
+		 * @brief Get number of tasks in lock-free ring of SubmissionMode::singleProducer
+		 * @return 0 in SubmissionMode::multipleProducers
+		 */
+		size_t getRingTasks() const;
+
+		/**
+		 * @brief Get number of threads that currently compensate blocking regions
+		 * @return
+		 */
+		size_t getCompensatingThreadsCount() const;
+
+		/**
+		 * @brief Set how many compensating threads can exist at once, including stopped threads that wait for reuse
+		 * @param maxCompensatingThreads Regions entered while limit is reached get no compensating thread(0 disables compensation)
+		 */
+		void setMaxCompensatingThreads(size_t maxCompensatingThreads);
+
+		/**
+		 * @brief Getter for maxCompensatingThreads
+		 * @return
+		 */
+		size_t getMaxCompensatingThreads() const;
+
 		/// @brief Check is thread pool has task that running in some thread
 		/// @return Returns true if thread pool has task
 		bool isAnyTaskRunning() const;
@@ -142,50 +544,90 @@ namespace threading
 
 		/**
 		 * @brief Get queued tasks
-		 * @return 
+		 * @param exact Read every queue under its lock. Otherwise sharded counters are summed without locks
+		 * @return Tasks in shared queue, in deadline queue and in mailboxes of worker threads
 		 */
-		size_t getQueuedTasks() const;
+		size_t getQueuedTasks(bool exact = false) const;
 
 		/// @brief Getter for threadsCount
-		/// @return Current count of threads in thread pool
+		/// @return Current count of threads in thread pool. Safe to call from tasks while ThreadPool is resized
 		size_t size() const;
 
+		/**
+		 * @brief Write executed task spans of worker threads and current compensating threads in Chrome trace JSON format that can be opened in Perfetto
+		 * @param path Output file
+		 * @details Spans are recorded only if library is built with THREAD_POOL_TRACING, otherwise trace has no events
+		 * @exception std::runtime_error Can't open output file
+		 */
+		void dumpTrace(const std::filesystem::path& path) const;
+
 		~ThreadPool();
+
+		friend class Partition;
+		friend class TaskGroup;
+		friend class Strand;
+		friend class SubmissionBuffer;
+		friend class AdmissionController;
+
+		template<std::default_initializable T>
+		friend class Pipeline;
 	};
 
-	template<typename R, typename... ArgsT, typename... Args>
-	std::unique_ptr<Future> ThreadPool::addTask(const std::function<R(ArgsT...)>& task, const std::function<void()>& callback, Args&&... args)
+	/**
+	 * @brief Marks code of task that blocks, for example in file IO
+	 * @details If region is entered in worker thread, compensating thread executes queued tasks until region ends.
+	 * Stopped compensating thread is reused by next region, number of threads is limited by setMaxCompensatingThreads
+	 */
+	class THREAD_POOL_API ThreadPool::BlockingRegion
+	{
+	private:
+		std::shared_ptr<Compensators> compensators;
+		Worker* compensator;
+
+	public:
+		BlockingRegion(ThreadPool& threadPool);
+
+		BlockingRegion(const BlockingRegion&) = delete;
+
+		BlockingRegion& operator =(const BlockingRegion&) = delete;
+
+		/// @brief Compensating thread stops after its current task
+		~BlockingRegion();
+	};
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(F&& task, const std::function<void()>& callback, Args&&... args)
 	{
 		return this->addTask
 		(
-			std::make_unique<FunctionWrapperTask<R>>(std::bind(task, std::forward<Args>(args)...), callback)
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...)
 		);
 	}
 
-	template<typename R, typename... ArgsT, typename... Args>
-	std::unique_ptr<Future> ThreadPool::addTask(R(*task)(ArgsT...), const std::function<void()>& callback, Args&&... args)
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(F&& task, std::function<void()>&& callback, Args&&... args)
 	{
 		return this->addTask
 		(
-			std::make_unique<FunctionWrapperTask<R>>(std::bind(task, std::forward<Args>(args)...), callback)
+			std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...)
 		);
 	}
 
-	template<typename R, typename... ArgsT, typename... Args>
-	std::unique_ptr<Future> ThreadPool::addTask(const std::function<R(ArgsT...)>& task, std::function<void()>&& callback, Args&&... args)
+	template<typename F, typename CallbackT, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...> && std::invocable<std::decay_t<CallbackT>, std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>&&>
+	void ThreadPool::addTask(F&& task, CallbackT&& callback, Args&&... args)
 	{
-		return this->addTask
+		this->enqueue
 		(
-			std::make_unique<FunctionWrapperTask<R>>(std::bind(task, std::forward<Args>(args)...), std::move(callback))
+			std::make_unique<DetachedTask<std::decay_t<F>, std::decay_t<CallbackT>, std::decay_t<Args>...>>(std::forward<F>(task), std::forward<CallbackT>(callback), std::forward<Args>(args)...)
 		);
 	}
 
-	template<typename R, typename... ArgsT, typename... Args>
-	std::unique_ptr<Future> ThreadPool::addTask(R(*task)(ArgsT...), std::function<void()>&& callback, Args&&... args)
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	void ThreadPool::spawn(F&& task, Args&&... args)
 	{
-		return this->addTask
+		this->enqueue
 		(
-			std::make_unique<FunctionWrapperTask<R>>(std::bind(task, std::forward<Args>(args)...), std::move(callback))
+			std::make_unique<DetachedTask<std::decay_t<F>, std::nullptr_t, std::decay_t<Args>...>>(std::forward<F>(task), nullptr, std::forward<Args>(args)...)
 		);
 	}
 
@@ -197,4 +639,133 @@ namespace threading
 			std::make_unique<TaskT>(std::forward<Args>(args)...)
 		);
 	}
+
+	template<std::predicate PredicateT>
+	size_t ThreadPool::runUntil(PredicateT&& predicate)
+	{
+		using namespace std::chrono_literals;
+
+		size_t result = 0;
+
+		while (!predicate())
+		{
+			if (this->tryExecuteTask(100us))
+			{
+				result++;
+			}
+		}
+
+		return result;
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(Affinity affinity, F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(std::move(newTask), affinity);
+
+		return result;
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(Affinity affinity, F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(std::move(newTask), affinity);
+
+		return result;
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> ThreadPool::addTask(Affinity affinity, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<TaskT>(std::forward<Args>(args)...);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(std::move(newTask), affinity);
+
+		return result;
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(Deadline deadline, F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(std::move(newTask), deadline);
+
+		return result;
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(Deadline deadline, F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(std::move(newTask), deadline);
+
+		return result;
+	}
+
+	template<std::derived_from<BaseTask> TaskT, typename... Args>
+	std::unique_ptr<Future> ThreadPool::addTask(Deadline deadline, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<TaskT>(std::forward<Args>(args)...);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(std::move(newTask), deadline);
+
+		return result;
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(Label label, F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), callback, std::forward<Args>(args)...);
+
+		newTask->label = label.name;
+
+		return this->addTask(std::move(newTask));
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addTask(Label label, F&& task, std::function<void()>&& callback, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<CallableTask<std::decay_t<F>, std::decay_t<Args>...>>(std::forward<F>(task), std::move(callback), std::forward<Args>(args)...);
+
+		newTask->label = label.name;
+
+		return this->addTask(std::move(newTask));
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	void ThreadPool::spawn(Label label, F&& task, Args&&... args)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<DetachedTask<std::decay_t<F>, std::nullptr_t, std::decay_t<Args>...>>(std::forward<F>(task), nullptr, std::forward<Args>(args)...);
+
+		newTask->label = label.name;
+
+		this->enqueue(std::move(newTask));
+	}
+
+	template<typename F, typename... Args> requires std::invocable<std::decay_t<F>, std::decay_t<Args>...>
+	std::unique_ptr<Future> ThreadPool::addBlockingTask(F&& task, const std::function<void()>& callback, Args&&... args)
+	{
+		return this->addTask
+		(
+			[this, task = std::forward<F>(task), ...args = std::forward<Args>(args)]() mutable
+			{
+				BlockingRegion region = this->blockingRegion();
+
+				return std::invoke(std::move(task), std::move(args)...);
+			},
+			callback
+		);
+	}
 }
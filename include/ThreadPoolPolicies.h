@@ -0,0 +1,367 @@
+#pragma once
+
+#include <thread>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <concepts>
+#include <new>
+
+#include "Utility/ConcurrentQueue.h"
+#include "Utility/BoundedQueue.h"
+
+namespace threading::policies
+{
+	/// @brief Unbounded queue protected by mutex
+	struct MutexQueue
+	{
+		template<typename T>
+		class Queue
+		{
+		private:
+			utility::ConcurrentQueue<T> data;
+
+		public:
+			Queue() = default;
+
+			bool push(T&& value);
+
+			std::optional<T> pop();
+
+			size_t size() const;
+
+			~Queue() = default;
+		};
+	};
+
+	/// @brief Lock-free queue with fixed capacity
+	template<size_t Capacity = 1024>
+	struct LockFreeQueue
+	{
+		template<typename T>
+		class Queue : public utility::BoundedQueue<T>
+		{
+		public:
+			Queue();
+
+			~Queue() = default;
+		};
+	};
+
+	/// @brief Idle workers sleep until new task is added
+	class BlockingIdle
+	{
+	private:
+		std::atomic_uint32_t epoch;
+
+	public:
+		BlockingIdle();
+
+		/**
+		 * @brief Sleep if hasWork returns false
+		 */
+		template<typename PredicateT>
+		void wait(PredicateT&& hasWork);
+
+		void notify();
+
+		void notifyAll();
+
+		~BlockingIdle() = default;
+	};
+
+	/// @brief Idle workers yield instead of sleeping. Lowest latency, but idle workers keep CPU busy
+	class SpinningIdle
+	{
+	public:
+		SpinningIdle() = default;
+
+		template<typename PredicateT>
+		void wait(PredicateT&& hasWork);
+
+		void notify();
+
+		void notifyAll();
+
+		~SpinningIdle() = default;
+	};
+
+	/// @brief Type erased task storage that allocates for big callables
+	using FunctionStorage = std::function<void()>;
+
+	/**
+	 * @brief Move only type erased task storage without allocations
+	 * @tparam Size Max size of stored callable
+	 */
+	template<size_t Size = 64>
+	class InplaceTask
+	{
+	private:
+		alignas(std::max_align_t) std::byte storage[Size];
+		void (*invokeFunction)(void*);
+		void (*moveFunction)(void* from, void* to);
+		void (*destroyFunction)(void*);
+
+	private:
+		void reset();
+
+	public:
+		InplaceTask();
+
+		template<typename F> requires (!std::same_as<std::decay_t<F>, InplaceTask> && std::invocable<std::decay_t<F>&>)
+		InplaceTask(F&& function);
+
+		InplaceTask(const InplaceTask&) = delete;
+
+		InplaceTask(InplaceTask&& other) noexcept;
+
+		InplaceTask& operator =(const InplaceTask&) = delete;
+
+		InplaceTask& operator =(InplaceTask&& other) noexcept;
+
+		void operator ()();
+
+		explicit operator bool() const;
+
+		~InplaceTask();
+	};
+
+	/// @brief Metrics are not collected
+	struct NoMetrics
+	{
+		void onSubmit();
+
+		void onExecute();
+	};
+
+	/// @brief Count submitted and executed tasks
+	class CountingMetrics
+	{
+	private:
+		alignas(64) std::atomic_size_t submitted;
+		alignas(64) std::atomic_size_t executed;
+
+	public:
+		CountingMetrics();
+
+		void onSubmit();
+
+		void onExecute();
+
+		size_t getSubmittedTasks() const;
+
+		size_t getExecutedTasks() const;
+
+		~CountingMetrics() = default;
+	};
+
+	template<typename T>
+	bool MutexQueue::Queue<T>::push(T&& value)
+	{
+		data.push(std::move(value));
+
+		return true;
+	}
+
+	template<typename T>
+	std::optional<T> MutexQueue::Queue<T>::pop()
+	{
+		return data.pop();
+	}
+
+	template<typename T>
+	size_t MutexQueue::Queue<T>::size() const
+	{
+		return data.size();
+	}
+
+	template<size_t Capacity>
+	template<typename T>
+	LockFreeQueue<Capacity>::Queue<T>::Queue() :
+		utility::BoundedQueue<T>(Capacity)
+	{
+
+	}
+
+	inline BlockingIdle::BlockingIdle() :
+		epoch(0)
+	{
+
+	}
+
+	template<typename PredicateT>
+	void BlockingIdle::wait(PredicateT&& hasWork)
+	{
+		uint32_t current = epoch.load();
+
+		// Task added after epoch was read changes epoch, so wait returns immediately
+		if (!hasWork())
+		{
+			epoch.wait(current);
+		}
+	}
+
+	inline void BlockingIdle::notify()
+	{
+		epoch.fetch_add(1);
+		epoch.notify_one();
+	}
+
+	inline void BlockingIdle::notifyAll()
+	{
+		epoch.fetch_add(1);
+		epoch.notify_all();
+	}
+
+	template<typename PredicateT>
+	void SpinningIdle::wait(PredicateT&& hasWork)
+	{
+		if (!hasWork())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	inline void SpinningIdle::notify()
+	{
+
+	}
+
+	inline void SpinningIdle::notifyAll()
+	{
+
+	}
+
+	template<size_t Size>
+	void InplaceTask<Size>::reset()
+	{
+		if (destroyFunction)
+		{
+			destroyFunction(storage);
+		}
+
+		invokeFunction = nullptr;
+		moveFunction = nullptr;
+		destroyFunction = nullptr;
+	}
+
+	template<size_t Size>
+	InplaceTask<Size>::InplaceTask() :
+		invokeFunction(nullptr),
+		moveFunction(nullptr),
+		destroyFunction(nullptr)
+	{
+
+	}
+
+	template<size_t Size>
+	template<typename F> requires (!std::same_as<std::decay_t<F>, InplaceTask<Size>> && std::invocable<std::decay_t<F>&>)
+	InplaceTask<Size>::InplaceTask(F&& function)
+	{
+		using FunctionT = std::decay_t<F>;
+
+		static_assert(sizeof(FunctionT) <= Size, "Callable doesn't fit in InplaceTask, increase Size");
+		static_assert(alignof(FunctionT) <= alignof(std::max_align_t), "Over-aligned callables are not supported");
+
+		new (storage) FunctionT(std::forward<F>(function));
+
+		invokeFunction = [](void* data) { (*static_cast<FunctionT*>(data))(); };
+		moveFunction = [](void* from, void* to)
+			{
+				new (to) FunctionT(std::move(*static_cast<FunctionT*>(from)));
+
+				static_cast<FunctionT*>(from)->~FunctionT();
+			};
+		destroyFunction = [](void* data) { static_cast<FunctionT*>(data)->~FunctionT(); };
+	}
+
+	template<size_t Size>
+	InplaceTask<Size>::InplaceTask(InplaceTask&& other) noexcept :
+		InplaceTask()
+	{
+		(*this) = std::move(other);
+	}
+
+	template<size_t Size>
+	InplaceTask<Size>& InplaceTask<Size>::operator =(InplaceTask&& other) noexcept
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
+		this->reset();
+
+		if (other.moveFunction)
+		{
+			other.moveFunction(other.storage, storage);
+
+			invokeFunction = other.invokeFunction;
+			moveFunction = other.moveFunction;
+			destroyFunction = other.destroyFunction;
+
+			other.invokeFunction = nullptr;
+			other.moveFunction = nullptr;
+			other.destroyFunction = nullptr;
+		}
+
+		return *this;
+	}
+
+	template<size_t Size>
+	void InplaceTask<Size>::operator ()()
+	{
+		invokeFunction(storage);
+	}
+
+	template<size_t Size>
+	InplaceTask<Size>::operator bool() const
+	{
+		return invokeFunction;
+	}
+
+	template<size_t Size>
+	InplaceTask<Size>::~InplaceTask()
+	{
+		this->reset();
+	}
+
+	inline void NoMetrics::onSubmit()
+	{
+
+	}
+
+	inline void NoMetrics::onExecute()
+	{
+
+	}
+
+	inline CountingMetrics::CountingMetrics() :
+		submitted(0),
+		executed(0)
+	{
+
+	}
+
+	inline void CountingMetrics::onSubmit()
+	{
+		submitted.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline void CountingMetrics::onExecute()
+	{
+		executed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	inline size_t CountingMetrics::getSubmittedTasks() const
+	{
+		return submitted.load(std::memory_order_relaxed);
+	}
+
+	inline size_t CountingMetrics::getExecutedTasks() const
+	{
+		return executed.load(std::memory_order_relaxed);
+	}
+}
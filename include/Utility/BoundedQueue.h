@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+namespace threading::utility
+{
+	/**
+	 * @brief Lock-free multi producer multi consumer queue with fixed capacity
+	 */
+	template<typename T>
+	class BoundedQueue
+	{
+	private:
+		struct Cell
+		{
+			std::atomic_size_t sequence;
+			std::optional<T> value;
+		};
+
+	private:
+		std::unique_ptr<Cell[]> cells;
+		size_t mask;
+		alignas(64) std::atomic_size_t head;
+		alignas(64) std::atomic_size_t tail;
+
+	public:
+		/**
+		 * @brief Construct BoundedQueue
+		 * @param capacity Max number of elements. Rounded up to power of 2
+		 */
+		BoundedQueue(size_t capacity = 1024);
+
+		BoundedQueue(const BoundedQueue&) = delete;
+
+		BoundedQueue& operator =(const BoundedQueue&) = delete;
+
+		/**
+		 * @brief Add element to queue
+		 * @param value New element. Not moved from if queue is full
+		 * @return false if queue is full
+		*/
+		bool push(T&& value);
+
+		/**
+		 * @brief Give out first element from queue
+		 * @return First element in queue
+		*/
+		std::optional<T> pop();
+
+		/**
+		 * @brief Approximate size of queue
+		 * @return Queue size
+		*/
+		size_t size() const;
+
+		/**
+		 * @brief Max number of elements
+		 * @return
+		 */
+		size_t capacity() const;
+
+		~BoundedQueue() = default;
+	};
+
+	template<typename T>
+	BoundedQueue<T>::BoundedQueue(size_t capacity) :
+		cells(std::make_unique<Cell[]>(std::bit_ceil((std::max)(capacity, static_cast<size_t>(2))))),
+		mask(std::bit_ceil((std::max)(capacity, static_cast<size_t>(2))) - 1),
+		head(0),
+		tail(0)
+	{
+		for (size_t i = 0; i <= mask; i++)
+		{
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	template<typename T>
+	bool BoundedQueue<T>::push(T&& value)
+	{
+		size_t position = tail.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			Cell& cell = cells[position & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+			if (!difference)
+			{
+				if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					cell.value.emplace(std::move(value));
+					cell.sequence.store(position + 1, std::memory_order_release);
+
+					return true;
+				}
+			}
+			else if (difference < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template<typename T>
+	std::optional<T> BoundedQueue<T>::pop()
+	{
+		size_t position = head.load(std::memory_order_relaxed);
+
+		while (true)
+		{
+			Cell& cell = cells[position & mask];
+			size_t sequence = cell.sequence.load(std::memory_order_acquire);
+			intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+			if (!difference)
+			{
+				if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					std::optional<T> result = std::move(cell.value);
+
+					cell.value.reset();
+					cell.sequence.store(position + mask + 1, std::memory_order_release);
+
+					return result;
+				}
+			}
+			else if (difference < 0)
+			{
+				return std::nullopt;
+			}
+			else
+			{
+				position = head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	template<typename T>
+	size_t BoundedQueue<T>::size() const
+	{
+		size_t currentTail = tail.load(std::memory_order_relaxed);
+		size_t currentHead = head.load(std::memory_order_relaxed);
+
+		return currentTail > currentHead ? currentTail - currentHead : 0;
+	}
+
+	template<typename T>
+	size_t BoundedQueue<T>::capacity() const
+	{
+		return mask + 1;
+	}
+}
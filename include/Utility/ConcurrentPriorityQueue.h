@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <optional>
+
+namespace threading::utility
+{
+	/**
+	 * @brief Priority queue protected by mutex
+	 * @tparam Compare Same as in std::priority_queue, pop gives out element for which compare returns false against all others
+	 */
+	template<typename T, typename Compare = std::less<T>>
+	class ConcurrentPriorityQueue
+	{
+	private:
+		std::vector<T> data;
+		std::mutex dataMutex;
+		std::atomic_size_t dataSize;
+		Compare compare;
+
+	public:
+		ConcurrentPriorityQueue(const Compare& compare = Compare());
+
+		ConcurrentPriorityQueue(const ConcurrentPriorityQueue&) = delete;
+
+		ConcurrentPriorityQueue& operator =(const ConcurrentPriorityQueue&) = delete;
+
+		/**
+		 * @brief Add element to queue
+		 * @param value New element
+		*/
+		void push(T&& value);
+
+		/**
+		 * @brief Give out element with highest priority
+		 * @return Element with highest priority
+		*/
+		std::optional<T> pop();
+
+		/**
+		 * @brief Current size of queue
+		 * @return Queue size
+		*/
+		size_t size() const;
+
+		/**
+		 * @brief Checks whether the queue is empty
+		 * @return
+		*/
+		bool empty() const;
+
+		/**
+		 * @brief Clear queue
+		*/
+		void clear();
+
+		~ConcurrentPriorityQueue() = default;
+	};
+
+	template<typename T, typename Compare>
+	ConcurrentPriorityQueue<T, Compare>::ConcurrentPriorityQueue(const Compare& compare) :
+		dataSize(0),
+		compare(compare)
+	{
+
+	}
+
+	template<typename T, typename Compare>
+	void ConcurrentPriorityQueue<T, Compare>::push(T&& value)
+	{
+		std::lock_guard<std::mutex> lock(dataMutex);
+
+		data.push_back(std::move(value));
+
+		std::push_heap(data.begin(), data.end(), compare);
+
+		dataSize++;
+	}
+
+	template<typename T, typename Compare>
+	std::optional<T> ConcurrentPriorityQueue<T, Compare>::pop()
+	{
+		if (this->empty())
+		{
+			return std::nullopt;
+		}
+
+		std::optional<T> result;
+
+		{
+			std::lock_guard<std::mutex> lock(dataMutex);
+
+			if (data.empty())
+			{
+				return std::nullopt;
+			}
+
+			std::pop_heap(data.begin(), data.end(), compare);
+
+			result = std::move(data.back());
+
+			data.pop_back();
+
+			dataSize--;
+		}
+
+		return result;
+	}
+
+	template<typename T, typename Compare>
+	size_t ConcurrentPriorityQueue<T, Compare>::size() const
+	{
+		return dataSize;
+	}
+
+	template<typename T, typename Compare>
+	bool ConcurrentPriorityQueue<T, Compare>::empty() const
+	{
+		return !this->size();
+	}
+
+	template<typename T, typename Compare>
+	void ConcurrentPriorityQueue<T, Compare>::clear()
+	{
+		std::lock_guard<std::mutex> lock(dataMutex);
+
+		data.clear();
+
+		dataSize = 0;
+	}
+}
@@ -1,22 +1,49 @@
 #pragma once
 
 #include <queue>
+#include <vector>
+#include <algorithm>
 #include <mutex>
 #include <atomic>
 #include <optional>
+#include <memory>
+#include <thread>
+#include <cstdint>
 
 namespace threading::utility
 {
 	template<typename T>
 	class ConcurrentQueue
 	{
+	private:
+		struct alignas(64) Shard
+		{
+			std::atomic<int64_t> size = 0;
+		};
+
 	private:
 		std::queue<T> data;
-		std::mutex dataMutex;
+		mutable std::mutex dataMutex;
 		std::atomic_size_t dataSize;
+		std::unique_ptr<Shard[]> shards;
+		size_t shardsCount;
+
+	private:
+		/// @brief Change single size counter after data was changed under lock
+		void changeLockedSize(int64_t difference);
+
+		/// @brief Change counter of current thread. Called after lock is released, except when elements must be visible before lock release
+		void changeShardedSize(int64_t difference);
+
+		Shard& currentShard();
 
 	public:
-		ConcurrentQueue() = default;
+		/**
+		 * @brief Construct ConcurrentQueue
+		 * @details In sharded mode push and pop change counter of calling thread outside of lock, and empty() sums counters instead of reading shared one
+		 * @param shardedSize Count size in per thread counters on separate cache lines instead of single counter. size() becomes approximate
+		 */
+		explicit ConcurrentQueue(bool shardedSize = false);
 
 		ConcurrentQueue(const ConcurrentQueue&) = delete;
 
@@ -38,17 +65,46 @@ namespace threading::utility
 		*/
 		void push(T&& value);
 
+		/**
+		 * @brief Add elements to queue under single lock
+		 * @param values New elements in order
+		*/
+		void pushBulk(std::vector<T>&& values);
+
 		/**
 		 * @brief Give out first element from queue
 		 * @return First element in queue
 		*/
 		std::optional<T> pop();
 
+		/**
+		 * @brief Give out up to maxCount first elements from queue under single lock
+		 * @param maxCount Max number of elements
+		 * @return Elements in queue order. Empty if queue is empty
+		*/
+		std::vector<T> popBulk(size_t maxCount);
+
+		/**
+		 * @brief Give out first element and move up to maxCount - 1 following elements to other queue
+		 * @details Both queues are locked together, so thread that checks this queue and then other queue always finds moved elements
+		 * @param maxCount Max number of elements taken from queue
+		 * @param other Queue for elements after first
+		 * @return First element in queue
+		*/
+		std::optional<T> popBulk(size_t maxCount, ConcurrentQueue& other);
+
 		/**
 		 * @brief Current size of queue
+		 * @param exact Read size under lock. Otherwise sharded size is summed without lock and can be approximate
 		 * @return Queue size
 		*/
-		size_t size() const;
+		size_t size(bool exact = false) const;
+
+		/**
+		 * @brief Checks whether size is counted in per thread counters
+		 * @return
+		 */
+		bool isSizeSharded() const;
 
 		/**
 		 * @brief Checks whether the queue is empty
@@ -65,7 +121,47 @@ namespace threading::utility
 	};
 
 	template<typename T>
-	ConcurrentQueue<T>::ConcurrentQueue(ConcurrentQueue&& other) noexcept
+	void ConcurrentQueue<T>::changeLockedSize(int64_t difference)
+	{
+		if (!shards)
+		{
+			dataSize += difference;
+		}
+	}
+
+	template<typename T>
+	void ConcurrentQueue<T>::changeShardedSize(int64_t difference)
+	{
+		if (shards)
+		{
+			this->currentShard().size.fetch_add(difference, std::memory_order_relaxed);
+		}
+	}
+
+	template<typename T>
+	typename ConcurrentQueue<T>::Shard& ConcurrentQueue<T>::currentShard()
+	{
+		static std::atomic_size_t nextIndex = 0;
+		static thread_local size_t index = nextIndex++;
+
+		return shards[index % shardsCount];
+	}
+
+	template<typename T>
+	ConcurrentQueue<T>::ConcurrentQueue(bool shardedSize) :
+		dataSize(0),
+		shardsCount(0)
+	{
+		if (shardedSize)
+		{
+			shardsCount = (std::max)(std::thread::hardware_concurrency(), 1U);
+			shards = std::make_unique<Shard[]>(shardsCount);
+		}
+	}
+
+	template<typename T>
+	ConcurrentQueue<T>::ConcurrentQueue(ConcurrentQueue&& other) noexcept :
+		ConcurrentQueue()
 	{
 		(*this) = std::move(other);
 	}
@@ -77,8 +173,11 @@ namespace threading::utility
 
 		data = std::move(other.data);
 		dataSize = other.dataSize.load();
+		shards = std::move(other.shards);
+		shardsCount = other.shardsCount;
 
 		other.dataSize = 0;
+		other.shardsCount = 0;
 
 		return *this;
 	}
@@ -86,21 +185,46 @@ namespace threading::utility
 	template<typename T>
 	void ConcurrentQueue<T>::push(const T& value)
 	{
-		std::lock_guard<std::mutex> lock(dataMutex);
+		{
+			std::lock_guard<std::mutex> lock(dataMutex);
+
+			data.push(value);
 
-		data.push(value);
+			this->changeLockedSize(1);
+		}
 
-		dataSize++;
+		this->changeShardedSize(1);
 	}
 
 	template<typename T>
 	void ConcurrentQueue<T>::push(T&& value)
 	{
-		std::lock_guard<std::mutex> lock(dataMutex);
+		{
+			std::lock_guard<std::mutex> lock(dataMutex);
+
+			data.push(std::move(value));
+
+			this->changeLockedSize(1);
+		}
+
+		this->changeShardedSize(1);
+	}
+
+	template<typename T>
+	void ConcurrentQueue<T>::pushBulk(std::vector<T>&& values)
+	{
+		{
+			std::lock_guard<std::mutex> lock(dataMutex);
 
-		data.push(std::move(value));
+			for (T& value : values)
+			{
+				data.push(std::move(value));
+			}
+
+			this->changeLockedSize(static_cast<int64_t>(values.size()));
+		}
 
-		dataSize++;
+		this->changeShardedSize(static_cast<int64_t>(values.size()));
 	}
 
 	template<typename T>
@@ -116,22 +240,131 @@ namespace threading::utility
 		{
 			std::lock_guard<std::mutex> lock(dataMutex);
 
+			if (data.empty())
+			{
+				return std::nullopt;
+			}
+
+			result = std::move(data.front());
+
+			data.pop();
+
+			this->changeLockedSize(-1);
+		}
+
+		this->changeShardedSize(-1);
+
+		return result;
+	}
+
+	template<typename T>
+	std::vector<T> ConcurrentQueue<T>::popBulk(size_t maxCount)
+	{
+		std::vector<T> result;
+
+		if (this->empty())
+		{
+			return result;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(dataMutex);
+
+			size_t count = (std::min)(maxCount, data.size());
+
+			result.reserve(count);
+
+			for (size_t i = 0; i < count; i++)
+			{
+				result.push_back(std::move(data.front()));
+
+				data.pop();
+			}
+
+			this->changeLockedSize(-static_cast<int64_t>(count));
+		}
+
+		this->changeShardedSize(-static_cast<int64_t>(result.size()));
+
+		return result;
+	}
+
+	template<typename T>
+	std::optional<T> ConcurrentQueue<T>::popBulk(size_t maxCount, ConcurrentQueue& other)
+	{
+		if (this->empty() || !maxCount)
+		{
+			return std::nullopt;
+		}
+
+		std::optional<T> result;
+		size_t count = 0;
+
+		{
+			std::scoped_lock<std::mutex, std::mutex> lock(dataMutex, other.dataMutex);
+
+			if (data.empty())
+			{
+				return std::nullopt;
+			}
+
+			count = (std::min)(maxCount, data.size());
+
 			result = std::move(data.front());
 
 			data.pop();
 
-			dataSize--;
+			for (size_t i = 1; i < count; i++)
+			{
+				other.data.push(std::move(data.front()));
+
+				data.pop();
+			}
+
+			// Other queue grows under lock, so thread that locks this queue after it shrunk also sees other queue grown
+			other.changeLockedSize(static_cast<int64_t>(count - 1));
+			other.changeShardedSize(static_cast<int64_t>(count - 1));
+
+			this->changeLockedSize(-static_cast<int64_t>(count));
 		}
 
+		this->changeShardedSize(-static_cast<int64_t>(count));
+
 		return result;
 	}
 
 	template<typename T>
-	size_t ConcurrentQueue<T>::size() const
+	size_t ConcurrentQueue<T>::size(bool exact) const
 	{
+		if (exact)
+		{
+			std::lock_guard<std::mutex> lock(dataMutex);
+
+			return data.size();
+		}
+
+		if (shards)
+		{
+			int64_t result = 0;
+
+			// Counters of different threads are read at different moments and changed after lock, so sum can be temporary negative
+			for (size_t i = 0; i < shardsCount; i++)
+			{
+				result += shards[i].size.load(std::memory_order_relaxed);
+			}
+
+			return static_cast<size_t>((std::max)(result, static_cast<int64_t>(0)));
+		}
+
 		return dataSize;
 	}
 
+	template<typename T>
+	bool ConcurrentQueue<T>::isSizeSharded() const
+	{
+		return static_cast<bool>(shards);
+	}
+
 	template<typename T>
 	bool ConcurrentQueue<T>::empty() const
 	{
@@ -143,11 +376,14 @@ namespace threading::utility
 	{
 		std::lock_guard<std::mutex> lock(dataMutex);
 
-		while (dataSize)
+		int64_t count = static_cast<int64_t>(data.size());
+
+		while (data.size())
 		{
 			data.pop();
-
-			dataSize--;
 		}
+
+		this->changeLockedSize(-count);
+		this->changeShardedSize(-count);
 	}
 }
@@ -28,6 +28,9 @@ namespace threading
 	{
 		if constexpr (std::is_same_v<R, void>)
 		{
+			// Rethrows exception of cancelled or failed task
+			implementation.get();
+
 			return std::any();
 		}
 		else
@@ -17,6 +17,8 @@ namespace threading
 
 		virtual void notify() override;
 
+		virtual void setException(std::exception_ptr exception) override;
+
 		std::promise<R>& getPromise();
 
 		virtual std::unique_ptr<Future> getFuture() override;
@@ -30,6 +32,12 @@ namespace threading
 		
 	}
 
+	template<typename R>
+	void FunctionWrapperPromise<R>::setException(std::exception_ptr exception)
+	{
+		implementation.set_exception(exception);
+	}
+
 	template<typename R>
 	std::promise<R>& FunctionWrapperPromise<R>::getPromise()
 	{
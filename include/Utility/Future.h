@@ -25,6 +25,11 @@ namespace threading
 
 		virtual void wait() = 0;
 
+		/**
+		 * @brief Wait for result
+		 * @tparam T Result type. void only waits and rethrows exception of task
+		 * @return Result of task
+		 */
 		template<typename T>
 		T get() const;
 
@@ -36,4 +41,10 @@ namespace threading
 	{
 		return std::any_cast<T>(this->getValue());
 	}
+
+	template<>
+	inline void Future::get<void>() const
+	{
+		this->getValue();
+	}
 }
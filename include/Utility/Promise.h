@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <exception>
 
 #include "Future.h"
 
@@ -13,6 +14,12 @@ namespace threading
 
 		virtual void notify() = 0;
 
+		/**
+		 * @brief Finish promise with exception instead of value
+		 * @param exception Rethrown from Future
+		 */
+		virtual void setException(std::exception_ptr exception);
+
 		virtual std::unique_ptr<Future> getFuture() = 0;
 
 		virtual ~Promise() = default;
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+
+namespace threading::utility
+{
+	/**
+	 * @brief Unbounded lock-free queue with many producers and one consumer
+	 */
+	template<typename T>
+	class SingleConsumerQueue
+	{
+	private:
+		struct Node
+		{
+			std::atomic<Node*> next;
+			std::optional<T> value;
+
+			Node();
+		};
+
+	private:
+		alignas(64) std::atomic<Node*> head;
+		alignas(64) Node* tail;
+
+	public:
+		SingleConsumerQueue();
+
+		SingleConsumerQueue(const SingleConsumerQueue&) = delete;
+
+		SingleConsumerQueue& operator =(const SingleConsumerQueue&) = delete;
+
+		/**
+		 * @brief Add element to queue. Can be called from any thread
+		 * @param value New element
+		*/
+		void push(T&& value);
+
+		/**
+		 * @brief Give out first element from queue. Must be called only from one thread at a time
+		 * @return First element in queue. Empty if queue is empty or producer hasn't finished push yet
+		*/
+		std::optional<T> pop();
+
+		~SingleConsumerQueue();
+	};
+
+	template<typename T>
+	SingleConsumerQueue<T>::Node::Node() :
+		next(nullptr)
+	{
+
+	}
+
+	template<typename T>
+	SingleConsumerQueue<T>::SingleConsumerQueue() :
+		head(new Node()),
+		tail(head.load())
+	{
+
+	}
+
+	template<typename T>
+	void SingleConsumerQueue<T>::push(T&& value)
+	{
+		Node* node = new Node();
+
+		node->value.emplace(std::move(value));
+
+		Node* previous = head.exchange(node, std::memory_order_acq_rel);
+
+		previous->next.store(node, std::memory_order_release);
+	}
+
+	template<typename T>
+	std::optional<T> SingleConsumerQueue<T>::pop()
+	{
+		Node* next = tail->next.load(std::memory_order_acquire);
+
+		if (!next)
+		{
+			return std::nullopt;
+		}
+
+		std::optional<T> result = std::move(next->value);
+
+		next->value.reset();
+
+		delete tail;
+
+		tail = next;
+
+		return result;
+	}
+
+	template<typename T>
+	SingleConsumerQueue<T>::~SingleConsumerQueue()
+	{
+		while (this->pop());
+
+		delete tail;
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <bit>
+#include <type_traits>
+#include <algorithm>
+
+namespace threading::utility
+{
+	/**
+	 * @brief Bounded lock-free ring with one producer and many consumers
+	 * @details Push is wait-free. Consumer reads slot before claiming it, so values must be trivially copyable
+	 */
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	class SingleProducerQueue
+	{
+	private:
+		std::unique_ptr<std::atomic<T>[]> slots;
+		size_t mask;
+		alignas(64) std::atomic_size_t head;
+		alignas(64) std::atomic_size_t tail;
+
+	public:
+		/// @param capacity Rounded up to power of two
+		SingleProducerQueue(size_t capacity);
+
+		SingleProducerQueue(const SingleProducerQueue&) = delete;
+
+		SingleProducerQueue& operator =(const SingleProducerQueue&) = delete;
+
+		/**
+		 * @brief Add element to queue. Must be called only from one thread at a time
+		 * @param value New element
+		 * @return false if queue is full
+		*/
+		bool push(T value);
+
+		/**
+		 * @brief Give out first element from queue. Can be called from any thread
+		 * @return First element in queue
+		*/
+		std::optional<T> pop();
+
+		/**
+		 * @brief Current size of queue
+		 * @return Queue size
+		*/
+		size_t size() const;
+
+		~SingleProducerQueue() = default;
+	};
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	SingleProducerQueue<T>::SingleProducerQueue(size_t capacity) :
+		slots(std::make_unique<std::atomic<T>[]>(std::bit_ceil((std::max)(capacity, static_cast<size_t>(1))))),
+		mask(std::bit_ceil((std::max)(capacity, static_cast<size_t>(1))) - 1),
+		head(0),
+		tail(0)
+	{
+
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	bool SingleProducerQueue<T>::push(T value)
+	{
+		size_t current = tail.load(std::memory_order_relaxed);
+
+		if (current - head.load(std::memory_order_acquire) > mask)
+		{
+			return false;
+		}
+
+		slots[current & mask].store(value, std::memory_order_release);
+
+		tail.store(current + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	std::optional<T> SingleProducerQueue<T>::pop()
+	{
+		size_t current = head.load(std::memory_order_acquire);
+
+		while (current != tail.load(std::memory_order_acquire))
+		{
+			// Slot is overwritten only after head moves past it, then claim below fails
+			T result = slots[current & mask].load(std::memory_order_acquire);
+
+			if (head.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel))
+			{
+				return result;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	size_t SingleProducerQueue<T>::size() const
+	{
+		size_t currentHead = head.load(std::memory_order_acquire);
+		size_t currentTail = tail.load(std::memory_order_acquire);
+
+		return currentTail > currentHead ? currentTail - currentHead : 0;
+	}
+}
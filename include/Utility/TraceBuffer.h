@@ -0,0 +1,157 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <string_view>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifndef THREAD_POOL_TRACE_CAPACITY
+#define THREAD_POOL_TRACE_CAPACITY 8192
+#endif
+
+namespace threading::utility
+{
+	/**
+	 * @brief Fixed size ring buffer of task spans with single writer. Each slot is guarded by sequence number, so reader skips events that are overwritten while it copies them
+	 */
+	class TraceBuffer
+	{
+	public:
+		struct Event
+		{
+			char name[48];
+			int64_t enqueueTime;
+			int64_t startTime;
+			int64_t endTime;
+		};
+
+	private:
+		static constexpr size_t nameWords = sizeof(Event::name) / sizeof(uint64_t);
+
+		/// @brief Event stored as atomics so reader can copy it while writer overwrites it
+		struct Slot
+		{
+			/// @brief 2 * index + 1 while event with that index is written, 2 * index + 2 when it is complete
+			std::atomic_size_t sequence;
+			std::atomic_uint64_t name[nameWords];
+			std::atomic_int64_t enqueueTime;
+			std::atomic_int64_t startTime;
+			std::atomic_int64_t endTime;
+		};
+
+	private:
+		std::vector<Slot> slots;
+		std::atomic_size_t head;
+
+	public:
+		/**
+		 * @brief Construct TraceBuffer
+		 * @param capacity Max number of stored events. Oldest events are overwritten
+		 */
+		TraceBuffer(size_t capacity = THREAD_POOL_TRACE_CAPACITY);
+
+		TraceBuffer(const TraceBuffer&) = delete;
+
+		TraceBuffer& operator =(const TraceBuffer&) = delete;
+
+		/**
+		 * @brief Add event. Must be called only from owning thread
+		 * @param name Task name
+		 * @param enqueueTime Time in nanoseconds when task was added to queue
+		 * @param startTime Time in nanoseconds when task started
+		 * @param endTime Time in nanoseconds when task finished
+		 */
+		void record(std::string_view name, int64_t enqueueTime, int64_t startTime, int64_t endTime);
+
+		/**
+		 * @brief Copy stored events. Can be called from any thread
+		 * @return Events from oldest to newest
+		 */
+		std::vector<Event> getEvents() const;
+
+		~TraceBuffer() = default;
+	};
+
+	inline TraceBuffer::TraceBuffer(size_t capacity) :
+		slots((std::max)(capacity, static_cast<size_t>(1))),
+		head(0)
+	{
+
+	}
+
+	inline void TraceBuffer::record(std::string_view name, int64_t enqueueTime, int64_t startTime, int64_t endTime)
+	{
+		size_t index = head.load(std::memory_order_relaxed);
+		Slot& slot = slots[index % slots.size()];
+		uint64_t words[nameWords] = {};
+		size_t nameSize = (std::min)(name.size(), sizeof(words) - 1);
+
+		std::memcpy(words, name.data(), nameSize);
+
+		slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (size_t i = 0; i < nameWords; i++)
+		{
+			slot.name[i].store(words[i], std::memory_order_relaxed);
+		}
+
+		slot.enqueueTime.store(enqueueTime, std::memory_order_relaxed);
+		slot.startTime.store(startTime, std::memory_order_relaxed);
+		slot.endTime.store(endTime, std::memory_order_relaxed);
+
+		slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+		head.store(index + 1, std::memory_order_release);
+	}
+
+	inline std::vector<TraceBuffer::Event> TraceBuffer::getEvents() const
+	{
+		size_t end = head.load(std::memory_order_acquire);
+		size_t start = end > slots.size() ? end - slots.size() : 0;
+		std::vector<Event> result;
+
+		result.reserve(end - start);
+
+		for (size_t i = start; i < end; i++)
+		{
+			const Slot& slot = slots[i % slots.size()];
+			size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+			// Writer already started to overwrite this event
+			if (sequence != 2 * i + 2)
+			{
+				continue;
+			}
+
+			uint64_t words[nameWords];
+			Event& event = result.emplace_back();
+
+			for (size_t j = 0; j < nameWords; j++)
+			{
+				words[j] = slot.name[j].load(std::memory_order_relaxed);
+			}
+
+			event.enqueueTime = slot.enqueueTime.load(std::memory_order_relaxed);
+			event.startTime = slot.startTime.load(std::memory_order_relaxed);
+			event.endTime = slot.endTime.load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// Event was overwritten while copying
+			if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+			{
+				result.pop_back();
+
+				continue;
+			}
+
+			std::memcpy(event.name, words, sizeof(event.name));
+		}
+
+		return result;
+	}
+}
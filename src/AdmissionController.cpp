@@ -0,0 +1,291 @@
+#include "AdmissionController.h"
+
+#include <cmath>
+
+namespace threading
+{
+	/// @brief Weight of new sample in moving averages
+	static constexpr double averageWeight = 0.125;
+
+	static int64_t currentTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	class AdmissionController::AdmissionTask : public BaseTask
+	{
+	private:
+		/// @brief Task leaves flight even if it throws
+		struct FinishGuard
+		{
+			State& state;
+
+			~FinishGuard()
+			{
+				state.finish();
+			}
+		};
+
+	private:
+		std::unique_ptr<BaseTask> task;
+		std::shared_ptr<State> state;
+		std::chrono::steady_clock::time_point admissionTime;
+
+	protected:
+		void executeImplementation() override
+		{
+			task->execute();
+		}
+
+		std::unique_ptr<Promise> createTaskPromise() const override
+		{
+			return nullptr;
+		}
+
+	public:
+		AdmissionTask(std::unique_ptr<BaseTask>&& task, const std::shared_ptr<State>& state) :
+			task(std::move(task)),
+			state(state),
+			admissionTime(std::chrono::steady_clock::now())
+		{
+
+		}
+
+		void execute() override
+		{
+			FinishGuard guard{ *state };
+
+			state->start(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - admissionTime));
+
+			this->executeImplementation();
+		}
+
+		float getProgress() const override
+		{
+			return task->getProgress();
+		}
+
+		std::string_view getName() const override
+		{
+			return task->getName();
+		}
+
+		~AdmissionTask() = default;
+	};
+
+	AdmissionRejected::AdmissionRejected(Reason reason) :
+		std::runtime_error(reason == Reason::maxInFlight ? "Task rejected, max number of tasks in flight reached" : "Task shed, queue wait time is above target delay"),
+		reason(reason)
+	{
+
+	}
+
+	AdmissionRejected::Reason AdmissionRejected::getReason() const
+	{
+		return reason;
+	}
+
+	AdmissionController::State::State(std::chrono::nanoseconds targetDelay, std::chrono::nanoseconds interval, size_t maxInFlight) :
+		targetDelay(targetDelay),
+		interval(interval),
+		maxInFlight(maxInFlight),
+		inFlightTasks(0),
+		queuedTasks(0),
+		acceptedTasks(0),
+		rejectedTasks(0),
+		shedTasks(0),
+		averageWaitTime(0.0),
+		averageQueueDepth(0.0),
+		firstAboveTime(0),
+		dropNext(0),
+		dropCount(0),
+		dropping(false)
+	{
+
+	}
+
+	void AdmissionController::State::start(std::chrono::nanoseconds waitTime)
+	{
+		queuedTasks--;
+
+		AdmissionController::updateAverage(averageWaitTime, static_cast<double>(waitTime.count()));
+
+		if (!targetDelay.count())
+		{
+			return;
+		}
+
+		if (waitTime < targetDelay)
+		{
+			firstAboveTime = 0;
+			dropping = false;
+
+			return;
+		}
+
+		int64_t now = currentTime();
+		int64_t expected = 0;
+
+		// Shedding starts only if wait time stays above target during whole interval
+		if (!firstAboveTime.compare_exchange_strong(expected, now + interval.count()) && now >= expected && !dropping.exchange(true))
+		{
+			dropCount = 0;
+			dropNext = now;
+		}
+	}
+
+	bool AdmissionController::State::drop()
+	{
+		int64_t now = currentTime();
+		int64_t next = dropNext;
+
+		if (now < next)
+		{
+			return false;
+		}
+
+		// Only one of concurrent producers sheds its task at scheduled time
+		size_t count = dropCount + 1;
+
+		if (!dropNext.compare_exchange_strong(next, now + static_cast<int64_t>(interval.count() / std::sqrt(static_cast<double>(count)))))
+		{
+			return false;
+		}
+
+		dropCount = count;
+
+		return true;
+	}
+
+	void AdmissionController::State::finish()
+	{
+		inFlightTasks--;
+	}
+
+	void AdmissionController::updateAverage(std::atomic<double>& average, double value)
+	{
+		double current = average.load(std::memory_order_relaxed);
+
+		while (!average.compare_exchange_weak(current, current + (value - current) * averageWeight, std::memory_order_relaxed));
+	}
+
+	std::unique_ptr<Future> AdmissionController::addTask(std::unique_ptr<BaseTask>&& task)
+	{
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*task);
+		size_t inFlightTasks = state->inFlightTasks++;
+
+		AdmissionController::updateAverage(state->averageQueueDepth, static_cast<double>(state->queuedTasks));
+
+		if (state->maxInFlight && inFlightTasks >= state->maxInFlight)
+		{
+			state->inFlightTasks--;
+			state->rejectedTasks++;
+
+			ThreadPool::cancelTask(*task, std::make_exception_ptr(AdmissionRejected(AdmissionRejected::Reason::maxInFlight)));
+
+			return result;
+		}
+
+		if (!inFlightTasks)
+		{
+			// Queue is drained, so there is no standing queue anymore
+			state->firstAboveTime = 0;
+			state->dropping = false;
+		}
+		else if (state->dropping && state->drop())
+		{
+			state->inFlightTasks--;
+			state->shedTasks++;
+
+			ThreadPool::cancelTask(*task, std::make_exception_ptr(AdmissionRejected(AdmissionRejected::Reason::targetDelay)));
+
+			return result;
+		}
+
+		state->acceptedTasks++;
+		state->queuedTasks++;
+
+		threadPool.enqueue(std::make_unique<AdmissionTask>(std::move(task), state));
+
+		return result;
+	}
+
+	AdmissionController::AdmissionController(ThreadPool& threadPool, std::chrono::microseconds targetDelay, std::chrono::microseconds interval, size_t maxInFlight) :
+		threadPool(threadPool),
+		state(std::make_shared<State>(targetDelay, interval, maxInFlight))
+	{
+
+	}
+
+	std::unique_ptr<Future> AdmissionController::addTask(const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, callback)
+		);
+	}
+
+	std::unique_ptr<Future> AdmissionController::addTask(const std::function<void()>& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, move(callback))
+		);
+	}
+
+	std::unique_ptr<Future> AdmissionController::addTask(std::function<void()>&& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), callback)
+		);
+	}
+
+	std::unique_ptr<Future> AdmissionController::addTask(std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback))
+		);
+	}
+
+	size_t AdmissionController::getAcceptedTasks() const
+	{
+		return state->acceptedTasks;
+	}
+
+	size_t AdmissionController::getRejectedTasks() const
+	{
+		return state->rejectedTasks;
+	}
+
+	size_t AdmissionController::getShedTasks() const
+	{
+		return state->shedTasks;
+	}
+
+	size_t AdmissionController::getInFlightTasks() const
+	{
+		return state->inFlightTasks;
+	}
+
+	std::chrono::nanoseconds AdmissionController::getAverageWaitTime() const
+	{
+		return std::chrono::nanoseconds(static_cast<int64_t>(state->averageWaitTime.load()));
+	}
+
+	double AdmissionController::getAverageQueueDepth() const
+	{
+		return state->averageQueueDepth;
+	}
+
+	std::chrono::nanoseconds AdmissionController::getTargetDelay() const
+	{
+		return state->targetDelay;
+	}
+
+	size_t AdmissionController::getMaxInFlight() const
+	{
+		return state->maxInFlight;
+	}
+}
@@ -0,0 +1,103 @@
+#include "ParallelFor.h"
+
+#include <map>
+#include <array>
+#include <tuple>
+
+namespace threading
+{
+	namespace
+	{
+		/// @brief Chunk size candidates give 1, 4, 16, 64 and 256 chunks per participant
+		constexpr size_t candidatesCount = 5;
+
+		/// @brief Fastest of several samples filters out preemption and wake up delays
+		constexpr size_t samplesPerCandidate = 2;
+
+		struct CallSiteTimings
+		{
+			/// @brief Fastest time per iteration of every candidate
+			std::array<double, candidatesCount> timePerIteration = {};
+			std::array<size_t, candidatesCount> samples = {};
+		};
+
+		std::mutex timingsMutex;
+		std::map<std::tuple<std::string_view, uint_least32_t, uint_least32_t>, CallSiteTimings> timings;
+
+		size_t candidateChunkSize(size_t candidate, size_t iterations, size_t participants)
+		{
+			return (std::max)(iterations / (participants << (candidate * 2)), static_cast<size_t>(1));
+		}
+
+		CallSiteTimings& callSiteTimings(const std::source_location& location)
+		{
+			return timings[{ location.file_name(), location.line(), location.column() }];
+		}
+	}
+
+	size_t LoopTuner::getChunkSize(const std::source_location& location, size_t iterations, size_t participants)
+	{
+		std::lock_guard<std::mutex> lock(timingsMutex);
+
+		const CallSiteTimings& callSite = callSiteTimings(location);
+		size_t next = 0;
+		size_t best = 0;
+
+		for (size_t i = 1; i < candidatesCount; i++)
+		{
+			// Small loops clamp several candidates to 1, only first of equal candidates is sampled
+			if (candidateChunkSize(i, iterations, participants) == candidateChunkSize(i - 1, iterations, participants))
+			{
+				break;
+			}
+
+			if (callSite.samples[i] < callSite.samples[next])
+			{
+				next = i;
+			}
+
+			if (callSite.timePerIteration[i] < callSite.timePerIteration[best])
+			{
+				best = i;
+			}
+		}
+
+		// Candidates are sampled round by round, after that choice of call site is fixed
+		return candidateChunkSize(callSite.samples[next] < samplesPerCandidate ? next : best, iterations, participants);
+	}
+
+	void LoopTuner::record(const std::source_location& location, size_t iterations, size_t participants, size_t chunkSize, std::chrono::nanoseconds time)
+	{
+		if (!iterations)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(timingsMutex);
+
+		CallSiteTimings& callSite = callSiteTimings(location);
+		double timePerIteration = static_cast<double>(time.count()) / iterations;
+
+		for (size_t i = 0; i < candidatesCount; i++)
+		{
+			if (candidateChunkSize(i, iterations, participants) != chunkSize)
+			{
+				continue;
+			}
+
+			if (callSite.samples[i] < samplesPerCandidate)
+			{
+				callSite.timePerIteration[i] = callSite.samples[i]++ ? (std::min)(callSite.timePerIteration[i], timePerIteration) : timePerIteration;
+			}
+
+			return;
+		}
+	}
+
+	void LoopTuner::reset()
+	{
+		std::lock_guard<std::mutex> lock(timingsMutex);
+
+		timings.clear();
+	}
+}
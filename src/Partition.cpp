@@ -0,0 +1,177 @@
+#include "Partition.h"
+
+#include <algorithm>
+
+namespace threading
+{
+	class Partition::DrainTask : public BaseTask
+	{
+	private:
+		std::shared_ptr<State> state;
+		bool executed;
+
+	protected:
+		void executeImplementation() override
+		{
+			executed = true;
+
+			Partition::drain(state);
+		}
+
+		std::unique_ptr<Promise> createTaskPromise() const override
+		{
+			return nullptr;
+		}
+
+	public:
+		DrainTask(const std::shared_ptr<State>& state) :
+			state(state),
+			executed(false)
+		{
+
+		}
+
+		void execute() override
+		{
+			this->executeImplementation();
+		}
+
+		std::string_view getName() const override
+		{
+			return "Partition";
+		}
+
+		/// @brief Drain that ThreadPool dropped on shutdown(false) frees its slot, so next added task schedules new drain
+		~DrainTask()
+		{
+			if (!executed)
+			{
+				state->scheduledDrains--;
+			}
+		}
+	};
+
+	Partition::State::State(ThreadPool& threadPool, size_t weight, size_t maxConcurrency) :
+		threadPool(threadPool),
+		scheduledDrains(0),
+		weight((std::max)(weight, static_cast<size_t>(1))),
+		maxConcurrency(maxConcurrency)
+	{
+
+	}
+
+	void Partition::schedule(const std::shared_ptr<State>& state)
+	{
+		size_t limit = state->maxConcurrency ? state->maxConcurrency : (std::max)(state->threadPool.size(), static_cast<size_t>(1));
+		size_t scheduled = state->scheduledDrains;
+
+		do
+		{
+			if (scheduled >= limit || scheduled >= state->tasks.size())
+			{
+				return;
+			}
+		} while (!state->scheduledDrains.compare_exchange_weak(scheduled, scheduled + 1));
+
+		state->threadPool.enqueue(std::make_unique<DrainTask>(state));
+	}
+
+	void Partition::drain(const std::shared_ptr<State>& state)
+	{
+		for (size_t i = 0; i < state->weight; i++)
+		{
+			std::optional<std::unique_ptr<BaseTask>> task = state->tasks.pop();
+
+			if (!task)
+			{
+				break;
+			}
+
+			ThreadPool::executeTask(**task);
+		}
+
+		if (state->tasks.size())
+		{
+			// Give other partitions their turn before continuing
+			state->threadPool.enqueue(std::make_unique<DrainTask>(state));
+
+			return;
+		}
+
+		state->scheduledDrains--;
+
+		// Task could be added between size check and decrement
+		Partition::schedule(state);
+	}
+
+	void Partition::enqueue(std::unique_ptr<BaseTask>&& task)
+	{
+		ThreadPool::markEnqueued(*task);
+
+		state->tasks.push(move(task));
+
+		Partition::schedule(state);
+	}
+
+	std::unique_ptr<Future> Partition::addTask(std::unique_ptr<BaseTask>&& task)
+	{
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*task);
+
+		this->enqueue(move(task));
+
+		return result;
+	}
+
+	Partition::Partition(ThreadPool& threadPool, size_t weight, size_t maxConcurrency) :
+		state(std::make_shared<State>(threadPool, weight, maxConcurrency))
+	{
+
+	}
+
+	std::unique_ptr<Future> Partition::addTask(const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, callback)
+		);
+	}
+
+	std::unique_ptr<Future> Partition::addTask(const std::function<void()>& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, move(callback))
+		);
+	}
+
+	std::unique_ptr<Future> Partition::addTask(std::function<void()>&& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), callback)
+		);
+	}
+
+	std::unique_ptr<Future> Partition::addTask(std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback))
+		);
+	}
+
+	size_t Partition::getQueuedTasks() const
+	{
+		return state->tasks.size();
+	}
+
+	size_t Partition::getWeight() const
+	{
+		return state->weight;
+	}
+
+	size_t Partition::getMaxConcurrency() const
+	{
+		return state->maxConcurrency;
+	}
+}
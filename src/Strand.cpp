@@ -0,0 +1,152 @@
+#include "Strand.h"
+
+#include <algorithm>
+
+namespace threading
+{
+	class Strand::DrainTask : public BaseTask
+	{
+	private:
+		std::shared_ptr<State> state;
+
+	protected:
+		void executeImplementation() override
+		{
+			Strand::drain(state);
+		}
+
+		std::unique_ptr<Promise> createTaskPromise() const override
+		{
+			return nullptr;
+		}
+
+	public:
+		DrainTask(const std::shared_ptr<State>& state) :
+			state(state)
+		{
+
+		}
+
+		void execute() override
+		{
+			this->executeImplementation();
+		}
+
+		std::string_view getName() const override
+		{
+			return "Strand";
+		}
+
+		~DrainTask() = default;
+	};
+
+	Strand::State::State(ThreadPool& threadPool, size_t weight) :
+		threadPool(threadPool),
+		pendingTasks(0),
+		weight((std::max)(weight, static_cast<size_t>(1)))
+	{
+
+	}
+
+	void Strand::drain(const std::shared_ptr<State>& state)
+	{
+		for (size_t i = 0; i < state->weight; i++)
+		{
+			std::optional<std::unique_ptr<BaseTask>> task = state->tasks.pop();
+
+			// Counter is increased after push, so producer is between publishing and linking its node. New drain picks task up instead of blocking worker thread
+			if (!task)
+			{
+				break;
+			}
+
+			try
+			{
+				ThreadPool::executeTask(**task);
+			}
+			catch (...)
+			{
+				// Strand keeps running, exception goes to Future of task
+				ThreadPool::cancelTask(**task, std::current_exception());
+			}
+
+			if (state->pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			{
+				return;
+			}
+		}
+
+		// Give other tasks of ThreadPool their turn before continuing
+		state->threadPool.enqueue(std::make_unique<DrainTask>(state));
+	}
+
+	void Strand::enqueue(std::unique_ptr<BaseTask>&& task)
+	{
+		ThreadPool::markEnqueued(*task);
+
+		state->tasks.push(move(task));
+
+		// Only thread that makes strand non empty schedules drain, so tasks never run concurrently
+		if (!state->pendingTasks.fetch_add(1, std::memory_order_acq_rel))
+		{
+			state->threadPool.enqueue(std::make_unique<DrainTask>(state));
+		}
+	}
+
+	std::unique_ptr<Future> Strand::addTask(std::unique_ptr<BaseTask>&& task)
+	{
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*task);
+
+		this->enqueue(move(task));
+
+		return result;
+	}
+
+	Strand::Strand(ThreadPool& threadPool, size_t weight) :
+		state(std::make_shared<State>(threadPool, weight))
+	{
+
+	}
+
+	std::unique_ptr<Future> Strand::addTask(const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, callback)
+		);
+	}
+
+	std::unique_ptr<Future> Strand::addTask(const std::function<void()>& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, move(callback))
+		);
+	}
+
+	std::unique_ptr<Future> Strand::addTask(std::function<void()>&& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), callback)
+		);
+	}
+
+	std::unique_ptr<Future> Strand::addTask(std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback))
+		);
+	}
+
+	size_t Strand::getPendingTasks() const
+	{
+		return state->pendingTasks;
+	}
+
+	size_t Strand::getWeight() const
+	{
+		return state->weight;
+	}
+}
@@ -0,0 +1,291 @@
+#include "SubmissionBuffer.h"
+
+#include <algorithm>
+#include <condition_variable>
+
+namespace threading
+{
+	/// @brief Background thread that flushes buffers whose oldest task waited linger time
+	/// @details Sleeps until the earliest flush time of buffered tasks, or until woken if all buffers are empty.
+	/// Shared by buffers with linger: started with the first of them and stopped when the last one is destroyed
+	class SubmissionBuffer::LingerFlusher
+	{
+	private:
+		std::vector<SubmissionBuffer*> buffers;
+		std::mutex buffersMutex;
+		std::condition_variable buffersChanged;
+		std::thread thread;
+		/// @brief Time when flusher wakes up by itself(max while it waits for wake)
+		std::chrono::steady_clock::time_point wakeTime;
+		bool running;
+
+	private:
+		void run();
+
+		LingerFlusher();
+
+	public:
+		/// @brief Get running flusher or start new one
+		static std::shared_ptr<LingerFlusher> acquire();
+
+		void add(SubmissionBuffer* buffer);
+
+		void remove(SubmissionBuffer* buffer);
+
+		/// @brief Wake flusher if buffer must be flushed before its wake time
+		void wake(std::chrono::steady_clock::time_point flushTime);
+
+		~LingerFlusher();
+	};
+
+	void SubmissionBuffer::LingerFlusher::run()
+	{
+		std::unique_lock<std::mutex> lock(buffersMutex);
+
+		while (running)
+		{
+			std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+			wakeTime = std::chrono::steady_clock::time_point::max();
+
+			for (SubmissionBuffer* buffer : buffers)
+			{
+				// Producers never take buffersMutex while holding tasksMutex
+				std::lock_guard<std::mutex> bufferLock(buffer->tasksMutex);
+
+				if (buffer->tasks.empty())
+				{
+					continue;
+				}
+
+				std::chrono::steady_clock::time_point flushTime = buffer->oldestTaskTime + buffer->linger;
+
+				if (flushTime <= now)
+				{
+					buffer->flushTasks();
+				}
+				else
+				{
+					wakeTime = (std::min)(wakeTime, flushTime);
+				}
+			}
+
+			if (wakeTime == std::chrono::steady_clock::time_point::max())
+			{
+				buffersChanged.wait(lock);
+			}
+			else
+			{
+				buffersChanged.wait_until(lock, wakeTime);
+			}
+		}
+	}
+
+	SubmissionBuffer::LingerFlusher::LingerFlusher() :
+		wakeTime(std::chrono::steady_clock::time_point::max()),
+		running(true)
+	{
+		thread = std::thread(&LingerFlusher::run, this);
+	}
+
+	std::shared_ptr<SubmissionBuffer::LingerFlusher> SubmissionBuffer::LingerFlusher::acquire()
+	{
+		static std::mutex instanceMutex;
+		static std::weak_ptr<LingerFlusher> instance;
+
+		std::lock_guard<std::mutex> lock(instanceMutex);
+		std::shared_ptr<LingerFlusher> result = instance.lock();
+
+		if (!result)
+		{
+			result = std::shared_ptr<LingerFlusher>(new LingerFlusher());
+
+			instance = result;
+		}
+
+		return result;
+	}
+
+	void SubmissionBuffer::LingerFlusher::add(SubmissionBuffer* buffer)
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+
+		buffers.push_back(buffer);
+	}
+
+	void SubmissionBuffer::LingerFlusher::remove(SubmissionBuffer* buffer)
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+
+		std::erase(buffers, buffer);
+	}
+
+	void SubmissionBuffer::LingerFlusher::wake(std::chrono::steady_clock::time_point flushTime)
+	{
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+
+			if (flushTime >= wakeTime)
+			{
+				return;
+			}
+
+			wakeTime = flushTime;
+		}
+
+		buffersChanged.notify_one();
+	}
+
+	SubmissionBuffer::LingerFlusher::~LingerFlusher()
+	{
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex);
+
+			running = false;
+		}
+
+		buffersChanged.notify_one();
+
+		thread.join();
+	}
+
+	void SubmissionBuffer::flushTasks()
+	{
+		if (tasks.empty())
+		{
+			return;
+		}
+
+		std::vector<std::unique_ptr<BaseTask>> batch;
+
+		batch.reserve(capacity);
+
+		batch.swap(tasks);
+
+		threadPool.enqueue(move(batch));
+	}
+
+	void SubmissionBuffer::enqueue(std::unique_ptr<BaseTask>&& task)
+	{
+		std::chrono::steady_clock::time_point flushTime = std::chrono::steady_clock::time_point::max();
+
+		{
+			std::lock_guard<std::mutex> lock(tasksMutex);
+
+			if (tasks.empty())
+			{
+				oldestTaskTime = std::chrono::steady_clock::now();
+
+				if (linger.count() > 0)
+				{
+					flushTime = oldestTaskTime + linger;
+				}
+			}
+
+			tasks.push_back(move(task));
+
+			if (tasks.size() >= capacity)
+			{
+				this->flushTasks();
+
+				flushTime = std::chrono::steady_clock::time_point::max();
+			}
+		}
+
+		// New batch may need flush before flusher wakes up
+		if (flushTime != std::chrono::steady_clock::time_point::max())
+		{
+			flusher->wake(flushTime);
+		}
+	}
+
+	std::unique_ptr<Future> SubmissionBuffer::addTask(std::unique_ptr<BaseTask>&& task)
+	{
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*task);
+
+		this->enqueue(move(task));
+
+		return result;
+	}
+
+	SubmissionBuffer::SubmissionBuffer(ThreadPool& threadPool, size_t capacity, std::chrono::microseconds linger) :
+		threadPool(threadPool),
+		capacity((std::max)(capacity, static_cast<size_t>(1))),
+		linger(linger)
+	{
+		tasks.reserve(this->capacity);
+
+		if (linger.count() > 0)
+		{
+			flusher = LingerFlusher::acquire();
+
+			flusher->add(this);
+		}
+	}
+
+	std::unique_ptr<Future> SubmissionBuffer::addTask(const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, callback)
+		);
+	}
+
+	std::unique_ptr<Future> SubmissionBuffer::addTask(const std::function<void()>& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, move(callback))
+		);
+	}
+
+	std::unique_ptr<Future> SubmissionBuffer::addTask(std::function<void()>&& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), callback)
+		);
+	}
+
+	std::unique_ptr<Future> SubmissionBuffer::addTask(std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback))
+		);
+	}
+
+	void SubmissionBuffer::flush()
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+
+		this->flushTasks();
+	}
+
+	size_t SubmissionBuffer::size() const
+	{
+		std::lock_guard<std::mutex> lock(tasksMutex);
+
+		return tasks.size();
+	}
+
+	size_t SubmissionBuffer::getCapacity() const
+	{
+		return capacity;
+	}
+
+	std::chrono::microseconds SubmissionBuffer::getLinger() const
+	{
+		return linger;
+	}
+
+	SubmissionBuffer::~SubmissionBuffer()
+	{
+		if (flusher)
+		{
+			flusher->remove(this);
+		}
+
+		this->flush();
+	}
+}
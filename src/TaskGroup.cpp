@@ -0,0 +1,203 @@
+#include "TaskGroup.h"
+
+#include <utility>
+
+namespace threading
+{
+	class TaskGroup::GroupTask : public BaseTask
+	{
+	private:
+		std::unique_ptr<BaseTask> task;
+		std::shared_ptr<State> state;
+
+	protected:
+		void executeImplementation() override
+		{
+			task->execute();
+		}
+
+		std::unique_ptr<Promise> createTaskPromise() const override
+		{
+			return nullptr;
+		}
+
+	public:
+		GroupTask(std::unique_ptr<BaseTask>&& task, const std::shared_ptr<State>& state) :
+			task(std::move(task)),
+			state(state)
+		{
+
+		}
+
+		void execute() override
+		{
+			FinishGuard guard{ *state };
+
+			try
+			{
+				this->executeImplementation();
+			}
+			catch (...)
+			{
+				std::exception_ptr exception = std::current_exception();
+
+				ThreadPool::cancelTask(*task, exception);
+
+				state->fail(exception);
+			}
+		}
+
+		float getProgress() const override
+		{
+			return task->getProgress();
+		}
+
+		std::string_view getName() const override
+		{
+			return task->getName();
+		}
+
+		~GroupTask() = default;
+	};
+
+	TaskGroup::State::State() :
+		pendingTasks(0)
+	{
+
+	}
+
+	void TaskGroup::State::fail(std::exception_ptr exception)
+	{
+		std::lock_guard<std::mutex> lock(exceptionMutex);
+
+		if (!this->exception)
+		{
+			this->exception = exception;
+		}
+	}
+
+	void TaskGroup::enqueue(std::unique_ptr<BaseTask>&& task)
+	{
+		if (partition)
+		{
+			partition->enqueue(std::move(task));
+		}
+		else
+		{
+			threadPool.enqueue(std::move(task));
+		}
+	}
+
+	void TaskGroup::help()
+	{
+		using namespace std::chrono_literals;
+
+		while (state->pendingTasks)
+		{
+			threadPool.tryExecuteTask(100us);
+		}
+	}
+
+	void TaskGroup::rethrow()
+	{
+		std::exception_ptr exception;
+
+		{
+			std::lock_guard<std::mutex> lock(state->exceptionMutex);
+
+			exception = std::exchange(state->exception, nullptr);
+		}
+
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+
+	std::unique_ptr<Future> TaskGroup::addTask(std::unique_ptr<BaseTask>&& task)
+	{
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*task);
+
+		state->pendingTasks++;
+
+		this->enqueue(std::make_unique<GroupTask>(std::move(task), state));
+
+		return result;
+	}
+
+	TaskGroup::TaskGroup(ThreadPool& threadPool, size_t maxConcurrency) :
+		threadPool(threadPool),
+		partition(maxConcurrency ? std::make_unique<Partition>(threadPool, 1, maxConcurrency) : nullptr),
+		state(std::make_shared<State>())
+	{
+
+	}
+
+	std::unique_ptr<Future> TaskGroup::addTask(const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, callback)
+		);
+	}
+
+	std::unique_ptr<Future> TaskGroup::addTask(const std::function<void()>& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(task, move(callback))
+		);
+	}
+
+	std::unique_ptr<Future> TaskGroup::addTask(std::function<void()>&& task, const std::function<void()>& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), callback)
+		);
+	}
+
+	std::unique_ptr<Future> TaskGroup::addTask(std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		return this->addTask
+		(
+			std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback))
+		);
+	}
+
+	void TaskGroup::wait()
+	{
+		size_t pendingTasks = state->pendingTasks;
+
+		while (pendingTasks)
+		{
+			state->pendingTasks.wait(pendingTasks);
+
+			pendingTasks = state->pendingTasks;
+		}
+
+		this->rethrow();
+	}
+
+	void TaskGroup::join()
+	{
+		this->help();
+
+		this->rethrow();
+	}
+
+	size_t TaskGroup::getPendingTasks() const
+	{
+		return state->pendingTasks;
+	}
+
+	size_t TaskGroup::getMaxConcurrency() const
+	{
+		return partition ? partition->getMaxConcurrency() : 0;
+	}
+
+	TaskGroup::~TaskGroup()
+	{
+		this->help();
+	}
+}
@@ -32,4 +32,9 @@ namespace threading
 	{
 		return 0.0f;
 	}
+
+	std::string_view BaseTask::getName() const
+	{
+		return label.empty() ? "BaseTask" : label;
+	}
 }
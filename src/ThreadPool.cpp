@@ -2,24 +2,295 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
+#include <iomanip>
+
+// Shared queue of ThreadPool that current worker thread serves
+static thread_local const void* currentTasks = nullptr;
+
+// Idle worker leaves affinity tasks of idle owner to that owner unless owner has more tasks than this
+static constexpr size_t mailboxStealThreshold = 1;
+
+#ifdef THREAD_POOL_TRACING
+static thread_local threading::utility::TraceBuffer* currentTraceBuffer = nullptr;
+
+static int64_t nanoseconds(std::chrono::steady_clock::time_point time)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+#endif
 
 namespace threading
 {
-	void ThreadPool::Worker::workerThread(std::shared_ptr<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>> tasks, std::shared_ptr<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>> hasTask)
+	Affinity::Affinity(size_t key) :
+		key(key)
+	{
+
+	}
+
+	Deadline::Deadline(std::chrono::steady_clock::time_point time) :
+		time(time)
+	{
+
+	}
+
+	Deadline::Deadline(std::chrono::steady_clock::duration timeout) :
+		time(std::chrono::steady_clock::now() + timeout)
+	{
+
+	}
+
+	Label::Label(std::string_view name) :
+		name(name)
+	{
+
+	}
+
+	DeadlineExceeded::DeadlineExceeded() :
+		std::runtime_error("Task deadline expired before it started")
+	{
+
+	}
+
+	bool ThreadPool::LaterDeadline::operator ()(const std::unique_ptr<BaseTask>& left, const std::unique_ptr<BaseTask>& right) const
+	{
+		return left->deadline > right->deadline;
+	}
+
+	ThreadPool::SubmissionRing::SubmissionRing(std::thread::id producer) :
+		tasks(submissionRingCapacity),
+		producer(producer),
+		sleepers(0),
+		waking(false)
+	{
+
+	}
+
+	bool ThreadPool::SubmissionRing::isProducer() const
+	{
+		return producer.load(std::memory_order_relaxed) == std::this_thread::get_id();
+	}
+
+	void ThreadPool::SubmissionRing::wake(std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>& hasTask)
+	{
+		// Pairs with fence of worker that goes to sleep: either producer sees sleeper or sleeper sees task
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		if (sleepers.load(std::memory_order_relaxed) && !waking.exchange(true))
+		{
+			hasTask.release();
+		}
+	}
+
+	ThreadPool::SubmissionRing::~SubmissionRing()
+	{
+		while (std::optional<BaseTask*> task = tasks.pop())
+		{
+			delete *task;
+		}
+	}
+
+	ThreadPool::BlockingRegion::BlockingRegion(ThreadPool& threadPool) :
+		compensator(nullptr)
+	{
+		if (currentTasks != threadPool.tasks.get())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(threadPool.compensators->mutex);
+		std::vector<Worker*>& threads = threadPool.compensators->threads;
+
+		if (threadPool.compensators->stopped)
+		{
+			return;
+		}
+
+		std::vector<Worker*>::iterator it = std::ranges::find_if(threads, [](Worker* worker) { return !worker->running; });
+
+		if (it == threads.end() && threads.size() >= threadPool.settings->maxCompensatingThreads)
+		{
+			return;
+		}
+
+		compensators = threadPool.compensators;
+
+		// Counted before thread starts, so task executed by new thread already sees it
+		compensators->active++;
+
+		if (it != threads.end())
+		{
+			compensator = *it;
+			compensator->running = true;
+		}
+		else
+		{
+			compensator = new Worker(&threadPool, true);
+
+			compensator->detach();
+
+			threads.push_back(compensator);
+		}
+	}
+
+	ThreadPool::BlockingRegion::~BlockingRegion()
+	{
+		if (!compensator)
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(compensators->mutex);
+
+		compensators->active--;
+
+		// Thread that thread pool stopped can be already gone
+		if (std::ranges::find(compensators->threads, compensator) != compensators->threads.end())
+		{
+			// Compensator stays blocked on semaphore until its next token, so next region can reuse it without starting thread
+			compensator->running = false;
+		}
+	}
+
+	bool ThreadPool::Compensators::leave(Worker& worker)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (worker.running)
+		{
+			return false;
+		}
+
+		std::erase(threads, &worker);
+
+		threadLeft.notify_all();
+
+		return true;
+	}
+
+	bool ThreadPool::Retirement::tryRetire()
+	{
+		size_t current = requests;
+
+		while (current)
+		{
+			if (requests.compare_exchange_weak(current, current - 1))
+			{
+				requests.notify_all();
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void ThreadPool::Worker::workerThread(std::shared_ptr<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>> tasks, std::shared_ptr<SubmissionRing> ring, std::shared_ptr<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>> hasTask, std::shared_ptr<DeadlineTasks> deadlineTasks, std::shared_ptr<MailboxList> mailboxes, std::shared_ptr<Retirement> retirement, std::shared_ptr<Settings> settings, std::shared_ptr<Compensators> compensators)
 	{
 		id = std::this_thread::get_id();
+		currentTasks = tasks.get();
+
+#ifdef THREAD_POOL_TRACING
+		currentTraceBuffer = traceBuffer.get();
+#endif
 
-		while (running)
+		// Compensating worker leaves only under lock, because region can reuse it while it is stopped
+		while (running || compensating)
 		{
+			if (ring && running)
+			{
+				// Ring tasks don't carry tokens, so worker drains ring before it waits
+				while (std::optional<BaseTask*> ringTask = ring->tasks.pop())
+				{
+					state = ThreadState::running;
+
+					this->execute(std::unique_ptr<BaseTask>(*ringTask), *deadlineTasks, settings->expiredTaskPolicy);
+
+					state = ThreadState::waiting;
+				}
+
+				ring->sleepers++;
+
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				if (ring->tasks.size())
+				{
+					ring->sleepers--;
+
+					continue;
+				}
+			}
+
 			hasTask->acquire();
 
+			if (ring)
+			{
+				ring->sleepers--;
+			}
+
+			if (!running && (!compensating || compensators->leave(*this)))
+			{
+				if (compensating)
+				{
+					// Token belongs to task or to other stopped thread
+					hasTask->release();
+				}
+
+				break;
+			}
+
+			if (!compensating && retirement->tryRetire())
+			{
+				retired = true;
+
+				retirement->retired++;
+				retirement->retired.notify_all();
+
+				break;
+			}
+
 			state = ThreadState::running;
 
-			if (std::optional<std::unique_ptr<BaseTask>> newTask = tasks->pop())
+			std::optional<std::unique_ptr<BaseTask>> newTask = ThreadPool::takeTask(*tasks, *deadlineTasks, *mailboxes, mailbox.get(), settings->batchSize);
+
+			if (!newTask && ring && ring->waking.exchange(false))
+			{
+				// Worker took token that wakes it for ring. Ring is empty if awake worker drained it, then token is just consumed
+				if (std::optional<BaseTask*> ringTask = ring->tasks.pop())
+				{
+					newTask = std::unique_ptr<BaseTask>(*ringTask);
+
+					if (ring->tasks.size())
+					{
+						ring->wake(*hasTask);
+					}
+				}
+				else
+				{
+					state = ThreadState::waiting;
+
+					continue;
+				}
+			}
+
+			if (newTask)
 			{
-				task = std::move(*newTask);
-				task->execute();
-				task.reset();
+				this->execute(std::move(*newTask), *deadlineTasks, settings->expiredTaskPolicy);
+			}
+			else
+			{
+				// Token belongs to affinity task that waits for its idle owner, to task that retiring worker moves from its mailbox to shared queue, or to retirement request that compensating worker can't take
+				hasTask->release();
+
+				if (size_t requests = retirement->requests; compensating && requests)
+				{
+					// Regular worker takes given back token, so compensating worker doesn't spin on it
+					retirement->requests.wait(requests);
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
 			}
 
 			state = ThreadState::waiting;
@@ -31,11 +302,35 @@ namespace threading
 		}
 	}
 
-	ThreadPool::Worker::Worker(ThreadPool* threadPool) :
+	void ThreadPool::Worker::execute(std::unique_ptr<BaseTask>&& newTask, DeadlineTasks& deadlineTasks, ExpiredTaskPolicy expiredTaskPolicy)
+	{
+		task = std::move(newTask);
+
+		if (mailbox)
+		{
+			mailbox->busy = true;
+		}
+
+		ThreadPool::executeTask(*task, deadlineTasks, expiredTaskPolicy);
+		task.reset();
+
+		if (mailbox)
+		{
+			mailbox->busy = false;
+		}
+	}
+
+	ThreadPool::Worker::Worker(ThreadPool* threadPool, bool compensating) :
 		state(ThreadState::waiting),
 		running(true),
-		deleteSelf(false),
-		thread(&Worker::workerThread, this, threadPool->tasks, threadPool->hasTask)
+		retired(false),
+		deleteSelf(compensating),
+#ifdef THREAD_POOL_TRACING
+		traceBuffer(std::make_unique<utility::TraceBuffer>()),
+#endif
+		mailbox(compensating ? nullptr : std::make_shared<Mailbox>(threadPool->shardedCounters)),
+		compensating(compensating),
+		thread(&Worker::workerThread, this, threadPool->tasks, threadPool->ring, threadPool->hasTask, threadPool->deadlineTasks, threadPool->mailboxes, threadPool->retirement, threadPool->settings, threadPool->compensators)
 	{
 
 	}
@@ -58,15 +353,284 @@ namespace threading
 		this->join();
 	}
 
-	std::unique_ptr<Future> ThreadPool::addTask(std::unique_ptr<BaseTask>&& task)
+	std::unique_ptr<Future> ThreadPool::prepareTask(BaseTask& task)
+	{
+		task.taskPromise = task.createTaskPromise();
+
+		return task.getFuture();
+	}
+
+	void ThreadPool::markEnqueued([[maybe_unused]] BaseTask& task)
+	{
+#ifdef THREAD_POOL_TRACING
+		task.enqueueTime = std::chrono::steady_clock::now();
+#endif
+	}
+
+	void ThreadPool::cancelTask(BaseTask& task, std::exception_ptr exception)
+	{
+		if (task.taskPromise)
+		{
+			task.taskPromise->setException(exception);
+		}
+	}
+
+	void ThreadPool::executeTask(BaseTask& task)
 	{
-		task->taskPromise = task->createTaskPromise();
+#ifdef THREAD_POOL_TRACING
+		if (currentTraceBuffer)
+		{
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			task.execute();
 
-		std::unique_ptr<Future> result = task->getFuture();
+			currentTraceBuffer->record(task.getName(), nanoseconds(task.enqueueTime), nanoseconds(start), nanoseconds(std::chrono::steady_clock::now()));
+
+			return;
+		}
+#endif
+
+		task.execute();
+	}
+
+	void ThreadPool::executeTask(BaseTask& task, DeadlineTasks& deadlineTasks, ExpiredTaskPolicy expiredTaskPolicy)
+	{
+		if (task.deadline == (std::chrono::steady_clock::time_point::max)())
+		{
+			ThreadPool::executeTask(task);
+
+			return;
+		}
+
+		if (expiredTaskPolicy == ExpiredTaskPolicy::cancel && std::chrono::steady_clock::now() > task.deadline)
+		{
+			deadlineTasks.expiredTasks++;
+			deadlineTasks.missedDeadlines++;
+
+			ThreadPool::cancelTask(task, std::make_exception_ptr(DeadlineExceeded()));
+
+			return;
+		}
+
+		ThreadPool::executeTask(task);
+
+		if (std::chrono::steady_clock::now() > task.deadline)
+		{
+			deadlineTasks.missedDeadlines++;
+		}
+	}
+
+	ThreadPool::Mailbox::Mailbox(bool shardedCounters) :
+		tasks(shardedCounters),
+		busy(false)
+	{
+
+	}
+
+	std::shared_ptr<const ThreadPool::Mailboxes> ThreadPool::MailboxList::load() const
+	{
+		std::shared_lock<std::shared_mutex> lock(mutex);
+
+		return mailboxes;
+	}
+
+	std::optional<std::unique_ptr<BaseTask>> ThreadPool::takeTask(TaskQueue& tasks, DeadlineTasks& deadlineTasks, const MailboxList& mailboxes, Mailbox* mailbox, size_t batchSize)
+	{
+		static thread_local size_t stealOffset = 0;
+
+		if (mailbox)
+		{
+			if (std::optional<std::unique_ptr<BaseTask>> task = mailbox->tasks.pop())
+			{
+				return task;
+			}
+		}
+
+		if (std::optional<std::unique_ptr<BaseTask>> task = deadlineTasks.tasks.pop())
+		{
+			return task;
+		}
+
+		if (mailbox && batchSize > 1)
+		{
+			// Fair share keeps other workers busy when queue is short
+			size_t count = (std::min)(batchSize, tasks.size() / (std::max)(mailboxes.workersCount.load(), static_cast<size_t>(1)));
+
+			if (count > 1)
+			{
+				// Tokens of moved tasks stay in semaphore, so worker takes them without waiting. Queues are locked together, so other workers that steal after checking shared queue never miss moved tasks
+				if (std::optional<std::unique_ptr<BaseTask>> task = tasks.popBulk(count, mailbox->tasks))
+				{
+					return task;
+				}
+			}
+		}
+
+		if (std::optional<std::unique_ptr<BaseTask>> task = tasks.pop())
+		{
+			return task;
+		}
+
+		std::shared_ptr<const Mailboxes> current = mailboxes.load();
+
+		stealOffset++;
+
+		for (size_t i = 0; i < current->size(); i++)
+		{
+			Mailbox& victim = *(*current)[(stealOffset + i) % current->size()];
+
+			if (&victim == mailbox)
+			{
+				continue;
+			}
+
+			// Idle owner soon takes its tasks itself, so they stay on the worker that has their data in cache
+			if (!victim.busy && victim.tasks.size() <= mailboxStealThreshold)
+			{
+				continue;
+			}
+
+			if (std::optional<std::unique_ptr<BaseTask>> task = victim.tasks.pop())
+			{
+				return task;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	void ThreadPool::enqueue(std::unique_ptr<BaseTask>&& task)
+	{
+		ThreadPool::markEnqueued(*task);
+
+		if (ring && ring->isProducer() && ring->tasks.push(task.get()))
+		{
+			task.release();
+
+			ring->wake(*hasTask);
+
+			return;
+		}
 
 		tasks->push(move(task));
 
 		hasTask->release();
+	}
+
+	void ThreadPool::enqueue(std::unique_ptr<BaseTask>&& task, Affinity affinity)
+	{
+		{
+			// Retiring workers move mailbox tasks to shared queue under unique lock
+			std::shared_lock<std::shared_mutex> lock(mailboxes->mutex);
+			const std::shared_ptr<const Mailboxes>& current = mailboxes->mailboxes;
+
+			if (current->size())
+			{
+				ThreadPool::markEnqueued(*task);
+
+				(*current)[affinity.key % current->size()]->tasks.push(move(task));
+			}
+		}
+
+		if (task)
+		{
+			this->enqueue(move(task));
+
+			return;
+		}
+
+		hasTask->release();
+	}
+
+	void ThreadPool::enqueue(std::vector<std::unique_ptr<BaseTask>>&& tasks)
+	{
+		ptrdiff_t count = static_cast<ptrdiff_t>(tasks.size());
+
+		for (std::unique_ptr<BaseTask>& task : tasks)
+		{
+			ThreadPool::markEnqueued(*task);
+		}
+
+		this->tasks->pushBulk(move(tasks));
+
+		hasTask->release(count);
+	}
+
+	void ThreadPool::enqueue(std::unique_ptr<BaseTask>&& task, Deadline deadline)
+	{
+		task->deadline = deadline.time;
+
+		ThreadPool::markEnqueued(*task);
+
+		deadlineTasks->tasks.push(move(task));
+
+		hasTask->release();
+	}
+
+	void ThreadPool::publishMailboxes()
+	{
+		std::shared_ptr<Mailboxes> current = std::make_shared<Mailboxes>();
+
+		current->reserve(workers.size());
+
+		for (Worker* worker : workers)
+		{
+			current->push_back(worker->mailbox);
+		}
+
+		std::unique_lock<std::shared_mutex> lock(mailboxes->mutex);
+
+		mailboxes->workersCount = current->size();
+		mailboxes->mailboxes = std::move(current);
+	}
+
+	bool ThreadPool::tryExecuteTask(std::chrono::microseconds timeout)
+	{
+		if (ring)
+		{
+			// Calling thread is awake, so it takes ring task without token
+			if (std::optional<BaseTask*> task = ring->tasks.pop())
+			{
+				std::unique_ptr<BaseTask> ringTask(*task);
+
+				ThreadPool::executeTask(*ringTask, *deadlineTasks, settings->expiredTaskPolicy);
+
+				return true;
+			}
+		}
+
+		if (!hasTask->try_acquire_for(timeout))
+		{
+			return false;
+		}
+
+		if (retirement->requests)
+		{
+			// Leave token for retiring worker
+			hasTask->release();
+
+			return false;
+		}
+
+		std::optional<std::unique_ptr<BaseTask>> task = ThreadPool::takeTask(*tasks, *deadlineTasks, *mailboxes, nullptr);
+
+		if (!task)
+		{
+			hasTask->release();
+
+			return false;
+		}
+
+		ThreadPool::executeTask(**task, *deadlineTasks, settings->expiredTaskPolicy);
+
+		return true;
+	}
+
+	std::unique_ptr<Future> ThreadPool::addTask(std::unique_ptr<BaseTask>&& task)
+	{
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*task);
+
+		this->enqueue(move(task));
 
 		return result;
 	}
@@ -78,7 +642,11 @@ namespace threading
 		return version;
 	}
 
-	ThreadPool::ThreadPool(size_t threadsCount)
+	ThreadPool::ThreadPool(size_t threadsCount, bool shardedCounters, SubmissionMode submissionMode) :
+		threadsCount(0),
+		shardedCounters(shardedCounters),
+		submissionMode(submissionMode),
+		producer(std::this_thread::get_id())
 	{
 		this->reinit(true, threadsCount);
 	}
@@ -115,15 +683,199 @@ namespace threading
 		);
 	}
 
+	std::unique_ptr<Future> ThreadPool::addTask(Affinity affinity, const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<FunctionWrapperTask<void>>(task, callback);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(move(newTask), affinity);
+
+		return result;
+	}
+
+	std::unique_ptr<Future> ThreadPool::addTask(Affinity affinity, std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback));
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(move(newTask), affinity);
+
+		return result;
+	}
+
+	std::unique_ptr<Future> ThreadPool::addTask(Deadline deadline, const std::function<void()>& task, const std::function<void()>& callback)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<FunctionWrapperTask<void>>(task, callback);
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(move(newTask), deadline);
+
+		return result;
+	}
+
+	std::unique_ptr<Future> ThreadPool::addTask(Deadline deadline, std::function<void()>&& task, std::function<void()>&& callback)
+	{
+		std::unique_ptr<BaseTask> newTask = std::make_unique<FunctionWrapperTask<void>>(move(task), move(callback));
+		std::unique_ptr<Future> result = ThreadPool::prepareTask(*newTask);
+
+		this->enqueue(move(newTask), deadline);
+
+		return result;
+	}
+
+	void ThreadPool::detachWorkers()
+	{
+		this->stopCompensators();
+
+		for (Worker* worker : workers)
+		{
+			worker->detach();
+
+			worker->deleteSelf = true;
+			worker->running = false;
+		}
+
+		hasTask->release(workers.size());
+
+		workers.clear();
+
+		this->threadsCount = 0;
+	}
+
+	void ThreadPool::stopCompensators()
+	{
+		std::lock_guard<std::mutex> lock(compensators->mutex);
+
+		compensators->stopped = true;
+
+		for (Worker* compensator : compensators->threads)
+		{
+			compensator->running = false;
+		}
+
+		// Every stopped thread gives its token to next one when it leaves
+		hasTask->release(compensators->threads.size());
+	}
+
+	void ThreadPool::retireWorkers(size_t count)
+	{
+		size_t retired = 0;
+
+		retirement->requests += count;
+
+		hasTask->release(count);
+
+		while ((retired = retirement->retired) < count)
+		{
+			retirement->retired.wait(retired);
+		}
+
+		retirement->retired -= count;
+
+		std::vector<Worker*> retiredWorkers;
+
+		std::erase_if
+		(
+			workers,
+			[&retiredWorkers](Worker* worker)
+			{
+				if (worker->retired)
+				{
+					retiredWorkers.push_back(worker);
+
+					return true;
+				}
+
+				return false;
+			}
+		);
+
+		this->threadsCount = workers.size();
+
+		this->publishMailboxes();
+
+		for (Worker* worker : retiredWorkers)
+		{
+			while (std::optional<std::unique_ptr<BaseTask>> task = worker->mailbox->tasks.pop())
+			{
+				tasks->push(std::move(*task));
+			}
+
+			delete worker;
+		}
+	}
+
 	void ThreadPool::reinit(bool wait, size_t threadsCount)
 	{
-		if (workers.size())
+		if (wait && workers.size())
 		{
-			this->shutdown(wait);
+			this->shutdown(true);
 		}
+		else if (workers.size())
+		{
+			std::shared_ptr<TaskQueue> oldTasks = std::move(tasks);
+			std::shared_ptr<SubmissionRing> oldRing = std::move(ring);
+			std::shared_ptr<DeadlineTasks> oldDeadlineTasks = std::move(deadlineTasks);
+			std::shared_ptr<const Mailboxes> oldMailboxes = mailboxes->load();
+
+			this->detachWorkers();
+
+			// Old workers keep old queues until they stop, so they can't take tasks that are counted for new workers
+			tasks = std::make_shared<TaskQueue>(shardedCounters);
+			deadlineTasks = std::make_shared<DeadlineTasks>();
 
-		hasTask = std::make_shared<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>>(0);
-		tasks = std::make_shared<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>>();
+			deadlineTasks->missedDeadlines = oldDeadlineTasks->missedDeadlines.load();
+			deadlineTasks->expiredTasks = oldDeadlineTasks->expiredTasks.load();
+
+			// Batch moves to mailbox under lock of shared queue, so after shared queue is drained old workers can't add tasks to their mailboxes
+			tasks->pushBulk(oldTasks->popBulk((std::numeric_limits<size_t>::max)()));
+
+			if (oldRing)
+			{
+				while (std::optional<BaseTask*> task = oldRing->tasks.pop())
+				{
+					tasks->push(std::unique_ptr<BaseTask>(*task));
+				}
+			}
+
+			while (std::optional<std::unique_ptr<BaseTask>> task = oldDeadlineTasks->tasks.pop())
+			{
+				deadlineTasks->tasks.push(std::move(*task));
+			}
+
+			for (const std::shared_ptr<Mailbox>& mailbox : *oldMailboxes)
+			{
+				while (std::optional<std::unique_ptr<BaseTask>> task = mailbox->tasks.pop())
+				{
+					tasks->push(std::move(*task));
+				}
+			}
+		}
+
+		if (!tasks)
+		{
+			tasks = std::make_shared<utility::ConcurrentQueue<std::unique_ptr<BaseTask>>>(shardedCounters);
+		}
+
+		if (!ring && submissionMode == SubmissionMode::singleProducer)
+		{
+			ring = std::make_shared<SubmissionRing>(producer);
+		}
+
+		if (!deadlineTasks)
+		{
+			deadlineTasks = std::make_shared<DeadlineTasks>();
+		}
+
+		if (!settings)
+		{
+			settings = std::make_shared<Settings>();
+		}
+
+		hasTask = std::make_shared<std::counting_semaphore<(std::numeric_limits<int32_t>::max)()>>(tasks->size(true) + deadlineTasks->tasks.size());
+		mailboxes = std::make_shared<MailboxList>();
+		retirement = std::make_shared<Retirement>();
+		compensators = std::make_shared<Compensators>();
 
 		workers.reserve(threadsCount);
 
@@ -131,6 +883,10 @@ namespace threading
 		{
 			workers.push_back(new Worker(this));
 		}
+
+		this->threadsCount = workers.size();
+
+		this->publishMailboxes();
 	}
 
 	bool ThreadPool::resize(size_t threadsCount)
@@ -146,10 +902,14 @@ namespace threading
 				workers.push_back(new Worker(this));
 			}
 
+			this->threadsCount = workers.size();
+
+			this->publishMailboxes();
+
 			return true;
 		}
 
-		this->reinit(false, threadsCount);
+		this->retireWorkers(workers.size() - threadsCount);
 
 		return true;
 	}
@@ -160,11 +920,14 @@ namespace threading
 
 		if (wait)
 		{
-			while (tasks->size())
+			while (this->getQueuedTasks(true))
 			{
 				std::this_thread::sleep_for(1s);
 			}
 
+			// Compensating threads stop first, so they don't take tokens of stopped workers
+			this->stopCompensators();
+
 			for (Worker* worker : workers)
 			{
 				worker->running = false;
@@ -178,23 +941,133 @@ namespace threading
 
 				delete worker;
 			}
+
+			std::unique_lock<std::mutex> lock(compensators->mutex);
+
+			compensators->threadLeft.wait(lock, [this]() { return compensators->threads.empty(); });
 		}
 		else
 		{
+			tasks->clear();
+			deadlineTasks->tasks.clear();
+
+			if (ring)
+			{
+				while (std::optional<BaseTask*> task = ring->tasks.pop())
+				{
+					delete *task;
+				}
+			}
+
 			for (Worker* worker : workers)
 			{
-				worker->detach();
+				worker->mailbox->tasks.clear();
+			}
 
-				worker->deleteSelf = true;
-				worker->running = false;
+			this->detachWorkers();
+		}
+
+		workers.clear();
+
+		this->threadsCount = 0;
+	}
+
+	size_t ThreadPool::runPending(size_t maxTasks)
+	{
+		size_t result = 0;
+
+		while (result < maxTasks && this->tryExecuteTask())
+		{
+			result++;
+		}
+
+		return result;
+	}
+
+	size_t ThreadPool::runFor(std::chrono::microseconds duration)
+	{
+		std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + duration;
+		size_t result = 0;
+
+		for (std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now(); now < deadline; now = std::chrono::steady_clock::now())
+		{
+			if (this->tryExecuteTask(std::chrono::duration_cast<std::chrono::microseconds>(deadline - now)))
+			{
+				result++;
 			}
+		}
 
-			tasks->clear();
+		return result;
+	}
 
-			hasTask->release(workers.size());
+	void ThreadPool::setBatchSize(size_t batchSize)
+	{
+		settings->batchSize = (std::max)(batchSize, static_cast<size_t>(1));
+	}
+
+	size_t ThreadPool::getBatchSize() const
+	{
+		return settings->batchSize;
+	}
+
+	void ThreadPool::setExpiredTaskPolicy(ExpiredTaskPolicy expiredTaskPolicy)
+	{
+		settings->expiredTaskPolicy = expiredTaskPolicy;
+	}
+
+	ThreadPool::ExpiredTaskPolicy ThreadPool::getExpiredTaskPolicy() const
+	{
+		return settings->expiredTaskPolicy;
+	}
+
+	size_t ThreadPool::getMissedDeadlines() const
+	{
+		return deadlineTasks->missedDeadlines;
+	}
+
+	size_t ThreadPool::getExpiredTasks() const
+	{
+		return deadlineTasks->expiredTasks;
+	}
+
+	ThreadPool::BlockingRegion ThreadPool::blockingRegion()
+	{
+		return BlockingRegion(*this);
+	}
+
+	ThreadPool::SubmissionMode ThreadPool::getSubmissionMode() const
+	{
+		return submissionMode;
+	}
+
+	void ThreadPool::bindProducer()
+	{
+		producer = std::this_thread::get_id();
+
+		if (ring)
+		{
+			ring->producer = producer;
 		}
+	}
 
-		workers.clear();
+	size_t ThreadPool::getRingTasks() const
+	{
+		return ring ? ring->tasks.size() : 0;
+	}
+
+	size_t ThreadPool::getCompensatingThreadsCount() const
+	{
+		return compensators->active;
+	}
+
+	void ThreadPool::setMaxCompensatingThreads(size_t maxCompensatingThreads)
+	{
+		settings->maxCompensatingThreads = maxCompensatingThreads;
+	}
+
+	size_t ThreadPool::getMaxCompensatingThreads() const
+	{
+		return settings->maxCompensatingThreads;
 	}
 
 	bool ThreadPool::isAnyTaskRunning() const
@@ -225,14 +1098,80 @@ namespace threading
 		return this->size();
 	}
 
-	size_t ThreadPool::getQueuedTasks() const
+	size_t ThreadPool::getQueuedTasks(bool exact) const
 	{
-		return tasks->size();
+		size_t result = tasks->size(exact) + deadlineTasks->tasks.size();
+
+		if (ring)
+		{
+			result += ring->tasks.size();
+		}
+
+		for (const std::shared_ptr<Mailbox>& mailbox : *mailboxes->load())
+		{
+			result += mailbox->tasks.size(exact);
+		}
+
+		return result;
 	}
 
 	size_t ThreadPool::size() const
 	{
-		return static_cast<size_t>(workers.size());
+		return threadsCount;
+	}
+
+	void ThreadPool::dumpTrace(const std::filesystem::path& path) const
+	{
+		std::ofstream output(path);
+
+		if (!output)
+		{
+			throw std::runtime_error("Can't open " + path.string());
+		}
+
+		output << std::fixed << std::setprecision(3) << R"({"traceEvents":[)";
+
+		bool first = true;
+
+		// Compensating threads follow workers and can't leave while their spans are written
+		std::lock_guard<std::mutex> lock(compensators->mutex);
+		std::vector<const Worker*> threads(workers.begin(), workers.end());
+
+		threads.insert(threads.end(), compensators->threads.begin(), compensators->threads.end());
+
+		for (size_t i = 0; i < threads.size(); i++)
+		{
+			if (!threads[i]->traceBuffer)
+			{
+				continue;
+			}
+
+			for (const utility::TraceBuffer::Event& event : threads[i]->traceBuffer->getEvents())
+			{
+				std::string name;
+
+				for (const char* c = event.name; *c; c++)
+				{
+					if (*c == '"' || *c == '\\')
+					{
+						name += '\\';
+					}
+
+					name += *c;
+				}
+
+				output << (first ? "" : ",")
+					<< R"({"name":")" << name
+					<< R"(","cat":"task","ph":"X","pid":0,"tid":)" << i
+					<< R"(,"ts":)" << event.startTime / 1000.0
+					<< R"(,"dur":)" << (event.endTime - event.startTime) / 1000.0
+					<< R"(,"args":{"queued_us":)" << (event.startTime - event.enqueueTime) / 1000.0 << "}}";
+
+				first = false;
+			}
+		}
+
+		output << "]}";
 	}
 
 	ThreadPool::~ThreadPool()
@@ -2,5 +2,8 @@
 
 namespace threading
 {
+	void Promise::setException([[maybe_unused]] std::exception_ptr exception)
+	{
 
+	}
 }